@@ -25,9 +25,42 @@
 
 #import <UIKit/UIKit.h>
 #import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "LFBinarySerialization.h"
+#import "LFBinaryURLSerialization.h"
+#import "LFURLSessionManager.h"
+#import "LFReplayURLProtocol.h"
+
+/** Number of times each decoding benchmark decodes the payload per measurement. */
+static NSUInteger const LFDecodingIterations = 20;
+
+/** Number of two-step chains each chaining benchmark runs per path. */
+static NSUInteger const LFChainCount = 200;
+
+/** Number of requests each dispatch benchmark sends per path. */
+static NSUInteger const LFDispatchRequestCount = 1000;
+
+// libmalloc calls this hook, when set, for every allocation on any thread.
+extern void (*malloc_logger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+
+static _Atomic uint64_t LFAllocationCount;
+
+static void LFCountAllocation(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+    if (type & 2) { // MALLOC_LOG_TYPE_ALLOCATE, also set for reallocations
+        atomic_fetch_add_explicit(&LFAllocationCount, 1, memory_order_relaxed);
+    }
+}
+
+typedef void(^LFDispatchRequestBlock)(LFURLSessionManager *manager, NSURLRequest *request, dispatch_block_t done);
 
 @interface LFNetworking_iOS_ExampleTests : XCTestCase
 
+@property (nonatomic, strong) NSDictionary *payload;
+@property (nonatomic, strong) NSDictionary *binaryPayload;
+@property (nonatomic, strong) NSData *JSONData;
+@property (nonatomic, strong) NSData *messagePackData;
+@property (nonatomic, strong) NSData *CBORData;
+
 @end
 
 @implementation LFNetworking_iOS_ExampleTests
@@ -35,6 +68,30 @@
 - (void)setUp {
     [super setUp];
     // Put setup code here. This method is called before the invocation of each test method in the class.
+    
+    // A page of a users/search style response, as a sync endpoint would return it.
+    NSMutableArray *users = [NSMutableArray array];
+    for (NSInteger i = 0; i < 500; i++) {
+        [users addObject:@{@"id": @(1000000 + i),
+                           @"username": [NSString stringWithFormat:@"user_%ld", (long)i],
+                           @"full_name": [NSString stringWithFormat:@"Example User Number %ld", (long)i],
+                           @"profile_picture": [NSString stringWithFormat:@"https://images.example.com/profiles/profile_%ld_75sq_1413000000.jpg", (long)i],
+                           @"bio": @"Photographer, traveller and occasional networking library benchmark fixture.",
+                           @"website": @"",
+                           @"counts": @{@"media": @(i * 3), @"follows": @(i * 7), @"followed_by": @(i * 11)},
+                           @"score": @(i / 7.0),
+                           @"verified": @((BOOL)(i % 2 == 0))}];
+    }
+    self.payload = @{@"meta": @{@"code": @200}, @"data": users};
+    
+    // JSON has no date type, so only the binary encodings carry a timestamp.
+    NSMutableDictionary *binaryPayload = [self.payload mutableCopy];
+    binaryPayload[@"generated_at"] = [NSDate dateWithTimeIntervalSince1970:1413000000];
+    self.binaryPayload = binaryPayload;
+    
+    self.JSONData = [NSJSONSerialization dataWithJSONObject:self.payload options:0 error:NULL];
+    self.messagePackData = [LFBinarySerialization dataWithObject:self.binaryPayload format:LFBinarySerializationFormatMessagePack error:NULL];
+    self.CBORData = [LFBinarySerialization dataWithObject:self.binaryPayload format:LFBinarySerializationFormatCBOR error:NULL];
 }
 
 - (void)tearDown {
@@ -47,6 +104,790 @@
     XCTAssert(YES, @"Pass");
 }
 
+- (void)assertObjectMatchesBinaryPayload:(NSDictionary *)object {
+    XCTAssertEqualObjects(object, self.binaryPayload);
+    XCTAssertTrue([object[@"generated_at"] isKindOfClass:[NSDate class]]);
+    XCTAssertTrue((__bridge CFBooleanRef)object[@"data"][0][@"verified"] == kCFBooleanTrue);
+    XCTAssertTrue((__bridge CFBooleanRef)object[@"data"][1][@"verified"] == kCFBooleanFalse);
+}
+
+- (void)testMessagePackRoundTrip {
+    NSError *error = nil;
+    id object = [LFBinarySerialization objectWithData:self.messagePackData format:LFBinarySerializationFormatMessagePack options:LFBinaryReadingNoCopy error:&error];
+    XCTAssertNil(error);
+    [self assertObjectMatchesBinaryPayload:object];
+}
+
+- (void)testCBORRoundTrip {
+    NSError *error = nil;
+    id object = [LFBinarySerialization objectWithData:self.CBORData format:LFBinarySerializationFormatCBOR options:LFBinaryReadingNoCopy error:&error];
+    XCTAssertNil(error);
+    [self assertObjectMatchesBinaryPayload:object];
+}
+
+- (void)testResponseSerializerDecodesErrorStatusBody {
+    
+    LFBinaryResponseSerializer *serializer = [LFBinaryResponseSerializer serializer];
+    NSURL *URL = [NSURL URLWithString:@"https://api.example.com/v1/users/self"];
+    NSData *data = [LFBinarySerialization dataWithObject:@{@"meta": @{@"code": @500}} format:LFBinarySerializationFormatMessagePack error:NULL];
+    
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:URL statusCode:500 HTTPVersion:@"HTTP/1.1" headerFields:@{@"Content-Type": @"application/msgpack"}];
+    NSError *error = nil;
+    XCTAssertEqualObjects([serializer responseObjectForResponse:response data:data error:&error], @{@"meta": @{@"code": @500}});
+    XCTAssertEqual(error.code, (NSInteger)NSURLErrorBadServerResponse);
+    
+    response = [[NSHTTPURLResponse alloc] initWithURL:URL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:@{@"Content-Type": @"text/html"}];
+    error = nil;
+    XCTAssertNil([serializer responseObjectForResponse:response data:data error:&error]);
+    XCTAssertEqual(error.code, (NSInteger)NSURLErrorCannotDecodeContentData);
+}
+
+- (void)testTruncatedMessagePackFails {
+    NSError *error = nil;
+    NSData *data = [self.messagePackData subdataWithRange:NSMakeRange(0, [self.messagePackData length] - 1)];
+    XCTAssertNil([LFBinarySerialization objectWithData:data format:LFBinarySerializationFormatMessagePack options:0 error:&error]);
+    XCTAssertEqual(error.code, LFBinarySerializationErrorTruncated);
+}
+
+- (void)testPerformanceJSONDecoding {
+    NSLog(@"JSON payload: %lu bytes", (unsigned long)[self.JSONData length]);
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < LFDecodingIterations; i++) {
+            [NSJSONSerialization JSONObjectWithData:self.JSONData options:0 error:NULL];
+        }
+    }];
+}
+
+- (void)testPerformanceMessagePackDecoding {
+    NSLog(@"MessagePack payload: %lu bytes", (unsigned long)[self.messagePackData length]);
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < LFDecodingIterations; i++) {
+            [LFBinarySerialization objectWithData:self.messagePackData format:LFBinarySerializationFormatMessagePack options:LFBinaryReadingNoCopy error:NULL];
+        }
+    }];
+}
+
+- (void)testPerformanceMessagePackDecodingWithCopies {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < LFDecodingIterations; i++) {
+            [LFBinarySerialization objectWithData:self.messagePackData format:LFBinarySerializationFormatMessagePack options:0 error:NULL];
+        }
+    }];
+}
+
+- (void)testPerformanceCBORDecoding {
+    NSLog(@"CBOR payload: %lu bytes", (unsigned long)[self.CBORData length]);
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < LFDecodingIterations; i++) {
+            [LFBinarySerialization objectWithData:self.CBORData format:LFBinarySerializationFormatCBOR options:LFBinaryReadingNoCopy error:NULL];
+        }
+    }];
+}
+
+#pragma mark -
+#pragma mark Tracing
+
+- (NSArray *)traceEventsOfTracer:(LFNetworkTracer *)tracer {
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[tracer traceEventData] options:0 error:NULL];
+    XCTAssertTrue([trace isKindOfClass:[NSDictionary class]]);
+    return trace[@"traceEvents"];
+}
+
+- (void)assertSpansAreBalancedInTracer:(LFNetworkTracer *)tracer {
+    
+    NSCountedSet *open = [NSCountedSet set];
+    NSUInteger spans = 0;
+    
+    for (NSDictionary *event in [self traceEventsOfTracer:tracer]) {
+        NSString *span = [NSString stringWithFormat:@"%@ %@", event[@"id"], event[@"name"]];
+        if ([event[@"ph"] isEqualToString:@"b"]) {
+            [open addObject:span];
+            spans++;
+        } else if ([event[@"ph"] isEqualToString:@"e"]) {
+            XCTAssertTrue([open containsObject:span], @"%@ ends without having begun", span);
+            [open removeObject:span];
+        }
+    }
+    
+    XCTAssertGreaterThan(spans, (NSUInteger)0);
+    XCTAssertEqual([open count], (NSUInteger)0, @"%@ never end", open);
+}
+
+- (void)testTracerKeepsNewestEventsWhenWrapping {
+    
+    LFNetworkTracer *tracer = [[LFNetworkTracer alloc] initWithCapacity:5];
+    XCTAssertEqual(tracer.capacity, (NSUInteger)8);
+    
+    for (int64_t i = 0; i < 20; i++) {
+        [tracer recordEvent:LFNetworkTraceData identifier:1 value:i];
+    }
+    
+    NSArray *events = [self traceEventsOfTracer:tracer];
+    XCTAssertEqual([events count], (NSUInteger)8);
+    [events enumerateObjectsUsingBlock:^(NSDictionary *event, NSUInteger idx, BOOL *stop) {
+        XCTAssertEqualObjects(event[@"args"][@"value"], @(12 + idx));
+    }];
+}
+
+- (void)testTracerResetAndDisabling {
+    
+    LFNetworkTracer *tracer = [[LFNetworkTracer alloc] init];
+    
+    [tracer recordEvent:LFNetworkTraceData identifier:1 value:1];
+    [tracer recordEvent:LFNetworkTraceData identifier:1 value:2];
+    [tracer reset];
+    XCTAssertEqual([[self traceEventsOfTracer:tracer] count], (NSUInteger)0);
+    
+    [tracer recordEvent:LFNetworkTraceData identifier:1 value:3];
+    XCTAssertEqualObjects([[self traceEventsOfTracer:tracer] valueForKeyPath:@"args.value"], @[@3]);
+    
+    tracer.enabled = NO;
+    [tracer beginSpan:LFNetworkTraceTask identifier:2];
+    [tracer recordEvent:LFNetworkTraceData identifier:2 value:4];
+    [tracer endSpan:LFNetworkTraceTask identifier:2];
+    XCTAssertEqual([[self traceEventsOfTracer:tracer] count], (NSUInteger)1);
+    
+    // Identifier zero marks untraced operations.
+    tracer.enabled = YES;
+    [tracer recordEvent:LFNetworkTraceData identifier:0 value:5];
+    XCTAssertEqual([[self traceEventsOfTracer:tracer] count], (NSUInteger)1);
+}
+
+- (void)testTracerExportsTraceEventFormat {
+    
+    LFNetworkTracer *tracer = [[LFNetworkTracer alloc] init];
+    uint64_t identifier = [tracer nextIdentifier];
+    
+    [tracer beginSpan:LFNetworkTraceTask identifier:identifier];
+    [tracer recordEvent:LFNetworkTraceResponse identifier:identifier value:200];
+    [tracer endSpan:LFNetworkTraceTask identifier:identifier];
+    
+    NSArray *events = [self traceEventsOfTracer:tracer];
+    XCTAssertEqualObjects([events valueForKey:@"ph"], (@[@"b", @"n", @"e"]));
+    XCTAssertEqualObjects([events valueForKey:@"name"], (@[@"task", @"response", @"task"]));
+    
+    double previousTimestamp = 0;
+    for (NSDictionary *event in events) {
+        XCTAssertEqualObjects(event[@"id"], ([NSString stringWithFormat:@"0x%llx", identifier]));
+        XCTAssertEqualObjects(event[@"cat"], @"LFNetworking");
+        XCTAssertTrue([event[@"tid"] isKindOfClass:[NSNumber class]]);
+        XCTAssertTrue([event[@"pid"] isKindOfClass:[NSNumber class]]);
+        XCTAssertGreaterThanOrEqual([event[@"ts"] doubleValue], previousTimestamp);
+        previousTimestamp = [event[@"ts"] doubleValue];
+        
+        if ([event[@"ph"] isEqualToString:@"n"]) {
+            XCTAssertEqualObjects(event[@"args"][@"value"], @200);
+        } else {
+            XCTAssertNil(event[@"args"]);
+        }
+    }
+}
+
+- (void)testTracedOperationsHaveBalancedSpans {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    manager.tracer = [[LFNetworkTracer alloc] init];
+    
+    XCTAssertNil([self completionErrorOfOperationWithManager:manager request:request deadline:nil]);
+    
+    NSArray *names = [[self traceEventsOfTracer:manager.tracer] valueForKey:@"name"];
+    for (NSString *span in @[@"queued", @"task", @"delivery"]) {
+        XCTAssertTrue([names containsObject:span], @"%@ span missing", span);
+    }
+    [self assertSpansAreBalancedInTracer:manager.tracer];
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testShedAndCancelledOperationsHaveBalancedSpans {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    manager.tracer = [[LFNetworkTracer alloc] init];
+    
+    XCTAssertNotNil([self completionErrorOfOperationWithManager:manager request:request deadline:[NSDate distantPast]]);
+    
+    dispatch_semaphore_t completed = dispatch_semaphore_create(0);
+    LFNetworkDataTaskOperation *operation = [manager dataOperationWithRequest:request progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+        dispatch_semaphore_signal(completed);
+    }];
+    [operation cancel];
+    [manager addOperation:operation];
+    XCTAssertEqual(dispatch_semaphore_wait(completed, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0L);
+    [[LFURLSessionManager sharedNetworkOperationQueue] waitUntilAllOperationsAreFinished];
+    
+    XCTAssertFalse([[[self traceEventsOfTracer:manager.tracer] valueForKey:@"name"] containsObject:@"task"]);
+    [self assertSpansAreBalancedInTracer:manager.tracer];
+    
+    [manager.session invalidateAndCancel];
+}
+
+#pragma mark -
+#pragma mark Dispatch
+
+- (LFURLSessionManager *)replayingManagerWithRequest:(NSURLRequest *)request {
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"LFDispatchBenchmark.lfna"];
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:@{@"Content-Type": @"application/json"}];
+    
+    LFNetworkArchiveWriter *writer = [[LFNetworkArchiveWriter alloc] initWithPath:path error:NULL];
+    [writer appendResponse:response data:[@"{\"meta\":{\"code\":200},\"data\":{\"id\":\"1000000\"}}" dataUsingEncoding:NSUTF8StringEncoding] forRequest:request error:NULL];
+    [writer finish:NULL];
+    
+    [LFReplayURLProtocol setArchive:[[LFNetworkArchive alloc] initWithContentsOfFile:path error:NULL]];
+    [LFReplayURLProtocol setLatency:0];
+    [LFReplayURLProtocol setBytesPerSecond:0];
+    
+    NSURLSessionConfiguration *configuration = [LFReplayURLProtocol sessionConfigurationWithConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    LFURLSessionManager *manager = [[LFURLSessionManager alloc] initWithSessionConfiguration:configuration];
+    manager.completionQueue = dispatch_queue_create("LFNetworking.tests.dispatch", DISPATCH_QUEUE_SERIAL);
+    
+    return manager;
+}
+
+- (void)sendRequests:(NSUInteger)count withManager:(LFURLSessionManager *)manager request:(NSURLRequest *)request usingBlock:(LFDispatchRequestBlock)block {
+    
+    dispatch_group_t group = dispatch_group_create();
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        dispatch_group_enter(group);
+        block(manager, request, ^{
+            dispatch_group_leave(group);
+        });
+    }
+    
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 60 * NSEC_PER_SEC)), 0L);
+}
+
+- (void)reportDispatchOverheadForPath:(NSString *)path usingBlock:(LFDispatchRequestBlock)block {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    
+    // Warm up class caches, the session and the record pool before measuring.
+    [self sendRequests:50 withManager:manager request:request usingBlock:block];
+    
+    atomic_store(&LFAllocationCount, 0);
+    malloc_logger = LFCountAllocation;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    [self sendRequests:LFDispatchRequestCount withManager:manager request:request usingBlock:block];
+    
+    CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+    malloc_logger = NULL;
+    
+    NSLog(@"%@ path: %.1f us and %.1f allocations per request", path,
+          elapsed * 1e6 / LFDispatchRequestCount,
+          (double)atomic_load(&LFAllocationCount) / LFDispatchRequestCount);
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testDirectDataTaskDeliversResponse {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    manager.maxConcurrentDirectTaskCount = 1;
+    
+    __block NSUInteger delivered = 0;
+    [self sendRequests:10 withManager:manager request:request usingBlock:^(LFURLSessionManager *manager, NSURLRequest *request, dispatch_block_t done) {
+        [manager directDataTaskWithRequest:request completionHandler:^(NSURLResponse *response, NSData *data, NSError *error) {
+            XCTAssertNil(error);
+            XCTAssertEqual([(NSHTTPURLResponse *)response statusCode], (NSInteger)200);
+            XCTAssertGreaterThan([data length], (NSUInteger)0);
+            delivered++;
+            done();
+        }];
+    }];
+    
+    XCTAssertEqual(delivered, (NSUInteger)10);
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testDirectTaskResumedByCallerIsNotReportedAsCancelled {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    manager.maxConcurrentDirectTaskCount = 1;
+    manager.tracer = [[LFNetworkTracer alloc] init];
+    
+    // Hold the only slot with a slow task. Its protocol reads the latency when it starts loading.
+    [LFReplayURLProtocol setLatency:5];
+    dispatch_semaphore_t slowCompleted = dispatch_semaphore_create(0);
+    NSURLSessionDataTask *slowTask = [manager directDataTaskWithRequest:request completionHandler:^(NSURLResponse *response, NSData *data, NSError *error) {
+        dispatch_semaphore_signal(slowCompleted);
+    }];
+    [NSThread sleepForTimeInterval:0.2];
+    [LFReplayURLProtocol setLatency:0];
+    
+    dispatch_semaphore_t completed = dispatch_semaphore_create(0);
+    NSURLSessionDataTask *task = [manager directDataTaskWithRequest:request completionHandler:^(NSURLResponse *response, NSData *data, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertGreaterThan([data length], (NSUInteger)0);
+        dispatch_semaphore_signal(completed);
+    }];
+    XCTAssertEqual(task.state, NSURLSessionTaskStateSuspended);
+    [task resume];
+    
+    XCTAssertEqual(dispatch_semaphore_wait(completed, dispatch_time(DISPATCH_TIME_NOW, 3 * NSEC_PER_SEC)), 0L);
+    XCTAssertFalse([[[self traceEventsOfTracer:manager.tracer] valueForKey:@"name"] containsObject:@"cancelled"]);
+    
+    [slowTask cancel];
+    XCTAssertEqual(dispatch_semaphore_wait(slowCompleted, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0L);
+    [self assertSpansAreBalancedInTracer:manager.tracer];
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testDirectTaskLimitMustAllowOneTask {
+    
+    LFURLSessionManager *manager = [[LFURLSessionManager alloc] init];
+    
+    XCTAssertThrows(manager.maxConcurrentDirectTaskCount = 0);
+    
+    manager.maxConcurrentDirectTaskCount = 2;
+    XCTAssertEqual(manager.maxConcurrentDirectTaskCount, (NSUInteger)2);
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testDispatchOverhead {
+    
+    [self reportDispatchOverheadForPath:@"Operation" usingBlock:^(LFURLSessionManager *manager, NSURLRequest *request, dispatch_block_t done) {
+        LFNetworkDataTaskOperation *operation = [manager dataOperationWithRequest:request progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+            XCTAssertNil(error);
+            done();
+        }];
+        [manager addOperation:operation];
+    }];
+    
+    [self reportDispatchOverheadForPath:@"Direct" usingBlock:^(LFURLSessionManager *manager, NSURLRequest *request, dispatch_block_t done) {
+        [manager directDataTaskWithRequest:request completionHandler:^(NSURLResponse *response, NSData *data, NSError *error) {
+            XCTAssertNil(error);
+            done();
+        }];
+    }];
+}
+
+#pragma mark -
+#pragma mark Archives
+
+- (NSString *)archivePathWithBodies:(NSArray *)bodies forRequest:(NSURLRequest *)request {
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"LFArchiveTests.lfna"];
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:201 HTTPVersion:@"HTTP/1.1" headerFields:@{@"Content-Type": @"text/plain", @"X-Count": @"1"}];
+    
+    NSError *error = nil;
+    LFNetworkArchiveWriter *writer = [[LFNetworkArchiveWriter alloc] initWithPath:path error:&error];
+    XCTAssertNotNil(writer, @"%@", error);
+    for (NSData *body in bodies) {
+        XCTAssertTrue([writer appendResponse:response data:body forRequest:request error:&error], @"%@", error);
+    }
+    XCTAssertTrue([writer finish:&error], @"%@", error);
+    
+    return path;
+}
+
+- (void)testArchiveRoundTripCyclesThroughRepeatedRequests {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    NSURLRequest *otherRequest = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/other"]];
+    NSArray *bodies = @[[@"first" dataUsingEncoding:NSUTF8StringEncoding], [@"second" dataUsingEncoding:NSUTF8StringEncoding]];
+    
+    NSError *error = nil;
+    LFNetworkArchive *archive = [[LFNetworkArchive alloc] initWithContentsOfFile:[self archivePathWithBodies:bodies forRequest:request] error:&error];
+    XCTAssertNotNil(archive, @"%@", error);
+    XCTAssertEqual(archive.count, (NSUInteger)2);
+    XCTAssertTrue([archive containsResponseForRequest:request]);
+    XCTAssertFalse([archive containsResponseForRequest:otherRequest]);
+    
+    for (NSUInteger i = 0; i < 4; i++) {
+        NSData *data = nil;
+        NSHTTPURLResponse *response = [archive responseForRequest:request data:&data];
+        XCTAssertEqual(response.statusCode, (NSInteger)201);
+        XCTAssertEqualObjects(response.allHeaderFields[@"X-Count"], @"1");
+        XCTAssertEqualObjects(response.allHeaderFields[@"Content-Length"], ([NSString stringWithFormat:@"%lu", (unsigned long)[bodies[i % 2] length]]));
+        XCTAssertEqualObjects(data, bodies[i % 2]);
+    }
+}
+
+- (void)testTruncatedArchiveIsRejected {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    NSString *path = [self archivePathWithBodies:@[[@"body" dataUsingEncoding:NSUTF8StringEncoding]] forRequest:request];
+    NSData *contents = [NSData dataWithContentsOfFile:path];
+    
+    for (NSUInteger length = 1; length < [contents length]; length++) {
+        [[contents subdataWithRange:NSMakeRange(0, length)] writeToFile:path atomically:YES];
+        NSError *error = nil;
+        XCTAssertNil([[LFNetworkArchive alloc] initWithContentsOfFile:path error:&error]);
+        XCTAssertEqual(error.code, (NSInteger)LFNetworkArchiveErrorCorrupt);
+    }
+}
+
+- (void)testArchiveWithNonStringHeaderIsRejected {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    NSString *path = [self archivePathWithBodies:@[[@"body" dataUsingEncoding:NSUTF8StringEncoding]] forRequest:request];
+    NSMutableData *contents = [NSMutableData dataWithContentsOfFile:path];
+    
+    // Same length, so every offset in the file stays valid and only the header value's type changes.
+    NSData *stringValue = [@"\"X-Count\":\"1\"" dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *numberValue = [@"\"X-Count\": 1 " dataUsingEncoding:NSUTF8StringEncoding];
+    NSRange range = [contents rangeOfData:stringValue options:0 range:NSMakeRange(0, [contents length])];
+    XCTAssertNotEqual(range.location, (NSUInteger)NSNotFound);
+    [contents replaceBytesInRange:range withBytes:[numberValue bytes]];
+    [contents writeToFile:path atomically:YES];
+    
+    NSError *error = nil;
+    XCTAssertNil([[LFNetworkArchive alloc] initWithContentsOfFile:path error:&error]);
+    XCTAssertEqual(error.code, (NSInteger)LFNetworkArchiveErrorCorrupt);
+}
+
+- (NSTimeInterval)timeToReplayRequest:(NSURLRequest *)request expectingData:(NSData *)expectedData {
+    
+    NSURLSessionConfiguration *configuration = [LFReplayURLProtocol sessionConfigurationWithConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    LFURLSessionManager *manager = [[LFURLSessionManager alloc] initWithSessionConfiguration:configuration];
+    manager.completionQueue = dispatch_queue_create("LFNetworking.tests.replay", DISPATCH_QUEUE_SERIAL);
+    
+    dispatch_semaphore_t completed = dispatch_semaphore_create(0);
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    __block CFAbsoluteTime end = 0;
+    
+    [manager directDataTaskWithRequest:request completionHandler:^(NSURLResponse *response, NSData *data, NSError *error) {
+        end = CFAbsoluteTimeGetCurrent();
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(data, expectedData);
+        dispatch_semaphore_signal(completed);
+    }];
+    
+    XCTAssertEqual(dispatch_semaphore_wait(completed, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0L);
+    [manager.session invalidateAndCancel];
+    
+    return end - start;
+}
+
+- (void)testReplayShapesLatencyAndBandwidth {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    NSData *body = [NSMutableData dataWithLength:20000];
+    [LFReplayURLProtocol setArchive:[[LFNetworkArchive alloc] initWithContentsOfFile:[self archivePathWithBodies:@[body] forRequest:request] error:NULL]];
+    
+    [LFReplayURLProtocol setLatency:0];
+    [LFReplayURLProtocol setBytesPerSecond:0];
+    NSTimeInterval unshaped = [self timeToReplayRequest:request expectingData:body];
+    
+    [LFReplayURLProtocol setLatency:0.3];
+    XCTAssertGreaterThanOrEqual([self timeToReplayRequest:request expectingData:body], 0.3);
+    
+    // 20000 bytes at 40000 bytes per second take half a second.
+    [LFReplayURLProtocol setLatency:0];
+    [LFReplayURLProtocol setBytesPerSecond:40000];
+    XCTAssertGreaterThanOrEqual([self timeToReplayRequest:request expectingData:body], 0.4);
+    
+    [LFReplayURLProtocol setBytesPerSecond:0];
+    XCTAssertLessThan(unshaped, 0.3);
+}
+
+#pragma mark -
+#pragma mark Promises
+
+- (void)testThenMapRecover {
+    
+    LFPromise *promise = [[[LFPromise promiseWithValue:@1] then:^id(id value) {
+        return [LFPromise promiseWithValue:@([value integerValue] + 1)];
+    }] map:^id(id value) {
+        return @([value integerValue] * 10);
+    }];
+    XCTAssertEqualObjects(promise.value, @20);
+    
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    
+    LFPromise *rejected = [[LFPromise promiseWithValue:@1] then:^id(id value) {
+        return error;
+    }];
+    XCTAssertEqualObjects(rejected.error, error);
+    
+    __block BOOL skipped = YES;
+    LFPromise *recovered = [[[LFPromise promiseWithError:error] map:^id(id value) {
+        skipped = NO;
+        return value;
+    }] recover:^id(NSError *error) {
+        return @"fallback";
+    }];
+    XCTAssertTrue(skipped);
+    XCTAssertEqualObjects(recovered.value, @"fallback");
+}
+
+- (void)testAllRejectionCancelsSiblings {
+    
+    LFPromise *first = [[LFPromise alloc] init];
+    LFPromise *second = [[LFPromise alloc] init];
+    LFPromise *third = [[LFPromise alloc] init];
+    LFPromise *all = [LFPromise all:@[first, second, third]];
+    
+    [first fulfill:@1];
+    XCTAssertFalse([all isSettled]);
+    
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    [second reject:error];
+    
+    XCTAssertEqualObjects(all.error, error);
+    XCTAssertEqualObjects(first.value, @1);
+    XCTAssertEqual(third.error.code, (NSInteger)NSURLErrorCancelled);
+}
+
+- (void)testCancellingOneChainKeepsSharedParent {
+    
+    LFPromise *search = [[LFPromise alloc] init];
+    NSBlockOperation *operation = [NSBlockOperation blockOperationWithBlock:^{}];
+    [search addCancellableOperation:operation];
+    
+    LFPromise *thumbnail = [[search then:^id(id value) { return value; }] map:^id(id value) { return value; }];
+    LFPromise *avatar = [search then:^id(id value) { return value; }];
+    
+    [thumbnail cancel];
+    XCTAssertEqual(thumbnail.error.code, (NSInteger)NSURLErrorCancelled);
+    XCTAssertFalse([search isSettled]);
+    XCTAssertFalse([avatar isSettled]);
+    XCTAssertFalse([operation isCancelled]);
+    
+    [avatar cancel];
+    XCTAssertEqual(search.error.code, (NSInteger)NSURLErrorCancelled);
+    XCTAssertTrue([operation isCancelled]);
+}
+
+- (void)testPromiseCancellationCancelsTask {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    [LFReplayURLProtocol setLatency:2];
+    
+    LFPromise *chain = [[manager promiseWithRequest:request] then:^id(id value) {
+        return value;
+    }];
+    [chain cancel];
+    XCTAssertEqual(chain.error.code, (NSInteger)NSURLErrorCancelled);
+    
+    dispatch_semaphore_t listed = dispatch_semaphore_create(0);
+    __block NSArray *tasks = nil;
+    [manager.session getTasksWithCompletionHandler:^(NSArray *dataTasks, NSArray *uploadTasks, NSArray *downloadTasks) {
+        tasks = dataTasks;
+        dispatch_semaphore_signal(listed);
+    }];
+    XCTAssertEqual(dispatch_semaphore_wait(listed, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0L);
+    for (NSURLSessionTask *task in tasks) {
+        XCTAssertNotEqual(task.state, NSURLSessionTaskStateRunning);
+    }
+    
+    [LFReplayURLProtocol setLatency:0];
+    [manager.session invalidateAndCancel];
+}
+
+// The gap is measured from the end of the first request's task span to the start of the second one.
+- (void)reportChainGapForPath:(NSString *)path usingBlock:(LFDispatchRequestBlock)block {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    
+    // Warm up class caches and the session before tracing.
+    [self sendRequests:20 withManager:manager request:request usingBlock:block];
+    
+    manager.tracer = [[LFNetworkTracer alloc] init];
+    for (NSUInteger i = 0; i < LFChainCount; i++) {
+        [self sendRequests:1 withManager:manager request:request usingBlock:block];
+    }
+    
+    NSMutableDictionary *taskEnds = [NSMutableDictionary dictionary];
+    NSMutableDictionary *starts = [NSMutableDictionary dictionary];
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[manager.tracer traceEventData] options:0 error:NULL];
+    for (NSDictionary *event in trace[@"traceEvents"]) {
+        NSNumber *identifier = @(strtoull([event[@"id"] UTF8String], NULL, 16));
+        if ([event[@"name"] isEqualToString:@"task"] && [event[@"ph"] isEqualToString:@"e"]) {
+            taskEnds[identifier] = event[@"ts"];
+        } else if ([event[@"name"] isEqualToString:@"started"]) {
+            starts[identifier] = event[@"ts"];
+        }
+    }
+    
+    // Each chain creates two operations, so the first step of every chain has an odd identifier.
+    double totalGap = 0;
+    NSUInteger gaps = 0;
+    for (uint64_t first = 1; first < 2 * LFChainCount; first += 2) {
+        NSNumber *end = taskEnds[@(first)];
+        NSNumber *start = starts[@(first + 1)];
+        if (end && start) {
+            totalGap += [start doubleValue] - [end doubleValue];
+            gaps++;
+        }
+    }
+    
+    XCTAssertEqual(gaps, LFChainCount);
+    NSLog(@"%@ chaining: %.1f us between steps", path, gaps ? totalGap / gaps : 0.0);
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testChainGap {
+    
+    [self reportChainGapForPath:@"Nested" usingBlock:^(LFURLSessionManager *manager, NSURLRequest *request, dispatch_block_t done) {
+        LFNetworkDataTaskOperation *operation = [manager dataOperationWithRequest:request progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+            LFNetworkDataTaskOperation *nextOperation = [manager dataOperationWithRequest:request progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+                done();
+            }];
+            [manager addOperation:nextOperation];
+        }];
+        [manager addOperation:operation];
+    }];
+    
+    [self reportChainGapForPath:@"Promise" usingBlock:^(LFURLSessionManager *manager, NSURLRequest *request, dispatch_block_t done) {
+        [[[manager promiseWithRequest:request] then:^id(id value) {
+            return [manager promiseWithRequest:request];
+        }] done:^(id value, NSError *error) {
+            done();
+        }];
+    }];
+}
+
+#pragma mark -
+#pragma mark Deadlines
+
+- (NSError *)completionErrorOfOperationWithManager:(LFURLSessionManager *)manager request:(NSURLRequest *)request deadline:(NSDate *)deadline {
+    
+    dispatch_semaphore_t completed = dispatch_semaphore_create(0);
+    __block NSError *completionError = nil;
+    __block NSData *completionData = nil;
+    
+    LFNetworkDataTaskOperation *operation = [manager dataOperationWithRequest:request deadline:deadline progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+        completionError = error;
+        completionData = data;
+        dispatch_semaphore_signal(completed);
+    }];
+    [manager addOperation:operation];
+    
+    XCTAssertEqual(dispatch_semaphore_wait(completed, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0L);
+    XCTAssertEqual([operation isDeadlineExceeded], (BOOL)(completionError != nil));
+    if (!completionError) {
+        XCTAssertGreaterThan([completionData length], (NSUInteger)0);
+    }
+    
+    return completionError;
+}
+
+- (void)testOperationPastDeadlineIsShed {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    [LFNetworkTaskOperation resetDeadlineCounters];
+    
+    NSError *error = [self completionErrorOfOperationWithManager:manager request:request deadline:[NSDate dateWithTimeIntervalSinceNow:-1]];
+    
+    XCTAssertEqualObjects(error.domain, LFNetworkTaskOperationErrorDomain);
+    XCTAssertEqual(error.code, LFNetworkTaskOperationErrorDeadlineExceeded);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsShedBeforeStart], (NSUInteger)1);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsCancelledAtDeadline], (NSUInteger)0);
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testRunningOperationIsCancelledAtDeadline {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    [LFNetworkTaskOperation resetDeadlineCounters];
+    [LFReplayURLProtocol setLatency:2];
+    
+    NSError *error = [self completionErrorOfOperationWithManager:manager request:request deadline:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    
+    XCTAssertEqualObjects(error.domain, LFNetworkTaskOperationErrorDomain);
+    XCTAssertEqual(error.code, LFNetworkTaskOperationErrorDeadlineExceeded);
+    XCTAssertEqual([error.userInfo[NSUnderlyingErrorKey] code], (NSInteger)NSURLErrorCancelled);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsShedBeforeStart], (NSUInteger)0);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsCancelledAtDeadline], (NSUInteger)1);
+    
+    [LFReplayURLProtocol setLatency:0];
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testOperationFinishingBeforeDeadlineSucceeds {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    [LFNetworkTaskOperation resetDeadlineCounters];
+    
+    XCTAssertNil([self completionErrorOfOperationWithManager:manager request:request deadline:[NSDate dateWithTimeIntervalSinceNow:10]]);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsShedBeforeStart], (NSUInteger)0);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsCancelledAtDeadline], (NSUInteger)0);
+    
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testOperationWithDistantFutureDeadlineSucceeds {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    [LFNetworkTaskOperation resetDeadlineCounters];
+    [LFReplayURLProtocol setLatency:0.2];
+    
+    XCTAssertNil([self completionErrorOfOperationWithManager:manager request:request deadline:[NSDate distantFuture]]);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsShedBeforeStart], (NSUInteger)0);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsCancelledAtDeadline], (NSUInteger)0);
+    
+    [LFReplayURLProtocol setLatency:0];
+    [manager.session invalidateAndCancel];
+}
+
+- (void)testDeadlineIsInheritedThroughDependencies {
+    
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.example.com/v1/users/self"]];
+    LFURLSessionManager *manager = [self replayingManagerWithRequest:request];
+    [LFNetworkTaskOperation resetDeadlineCounters];
+    
+    dispatch_semaphore_t completed = dispatch_semaphore_create(0);
+    __block NSError *searchError = nil;
+    LFNetworkDataTaskOperation *search = [manager dataOperationWithRequest:request progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+        searchError = error;
+        dispatch_semaphore_signal(completed);
+    }];
+    LFNetworkDataTaskOperation *thumbnail = [manager dataOperationWithRequest:request progressHandler:nil completionHandler:nil];
+    LFNetworkDataTaskOperation *avatar = [manager dataOperationWithRequest:request progressHandler:nil completionHandler:nil];
+    
+    NSDate *thumbnailDeadline = [NSDate dateWithTimeIntervalSinceNow:30];
+    NSDate *avatarDeadline = [NSDate dateWithTimeIntervalSinceNow:60];
+    
+    [thumbnail addDependency:search];
+    XCTAssertNil(search.deadline);
+    
+    thumbnail.deadline = thumbnailDeadline;
+    XCTAssertEqualObjects(search.deadline, thumbnailDeadline);
+    
+    [avatar addDependency:search];
+    XCTAssertNil(search.deadline, @"A dependent without a deadline waits for the result indefinitely.");
+    
+    avatar.deadline = avatarDeadline;
+    XCTAssertEqualObjects(search.deadline, avatarDeadline);
+    
+    [avatar removeDependency:search];
+    XCTAssertEqualObjects(search.deadline, thumbnailDeadline);
+    
+    [avatar addDependency:search];
+    [avatar cancel];
+    XCTAssertEqualObjects(search.deadline, thumbnailDeadline);
+    
+    // With every dependent gone, the search is stale work and is shed.
+    [thumbnail cancel];
+    XCTAssertEqualObjects(search.deadline, [NSDate distantPast]);
+    
+    [manager addOperation:search];
+    XCTAssertEqual(dispatch_semaphore_wait(completed, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0L);
+    XCTAssertEqual(searchError.code, LFNetworkTaskOperationErrorDeadlineExceeded);
+    XCTAssertEqual([LFNetworkTaskOperation numberOfOperationsShedBeforeStart], (NSUInteger)1);
+    
+    [manager.session invalidateAndCancel];
+}
+
 - (void)testPerformanceExample {
     // This is an example of a performance test case.
     [self measureBlock:^{
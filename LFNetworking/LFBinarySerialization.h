@@ -0,0 +1,92 @@
+//
+//  LFBinarySerialization.h
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+/** The error domain of errors created by `LFBinarySerialization`. */
+extern NSString * const LFBinarySerializationErrorDomain;
+
+typedef NS_ENUM(NSInteger, LFBinarySerializationError) {
+    /** The data ended in the middle of a value. */
+    LFBinarySerializationErrorTruncated = 1,
+    /** The data is not valid in the format, or contains a value that cannot be represented in Foundation. */
+    LFBinarySerializationErrorMalformed = 2,
+    /** Containers are nested too deeply. */
+    LFBinarySerializationErrorTooDeep = 3,
+    /** There are bytes left after the top-level value. */
+    LFBinarySerializationErrorTrailingData = 4,
+    /** An object cannot be encoded. */
+    LFBinarySerializationErrorUnsupportedObject = 5,
+};
+
+typedef NS_ENUM(NSInteger, LFBinarySerializationFormat) {
+    /** MessagePack (https://msgpack.org). */
+    LFBinarySerializationFormatMessagePack = 0,
+    /** CBOR (RFC 7049). */
+    LFBinarySerializationFormatCBOR = 1,
+};
+
+typedef NS_OPTIONS(NSUInteger, LFBinaryReadingOptions) {
+    /** Return longer strings and byte strings as slices of the input rather than copies. The slices retain the input,
+     *  so this is only safe if the caller does not mutate it afterwards. */
+    LFBinaryReadingNoCopy = 1 << 0,
+};
+
+/** Converts between MessagePack or CBOR and Foundation objects, in the manner of `NSJSONSerialization`.
+ *
+ * Maps become `NSDictionary`, arrays `NSArray`, strings `NSString`, byte strings `NSData`, integers, floats and booleans
+ * `NSNumber`, nil/null/undefined `NSNull`, and timestamps (MessagePack extension -1, CBOR tag 1) `NSDate`. Other
+ * MessagePack extensions decode to their payload as `NSData`; other CBOR tags decode to their content.
+ */
+
+@interface LFBinarySerialization : NSObject
+
+/** Decode a value.
+ *
+ * @param data The encoded value.
+ * @param format The format of `data`.
+ * @param options Reading options.
+ * @param error On failure, the reason.
+ *
+ * @return The decoded object, or `nil` on failure.
+ */
++ (id)objectWithData:(NSData *)data
+              format:(LFBinarySerializationFormat)format
+             options:(LFBinaryReadingOptions)options
+               error:(NSError **)error;
+
+/** Encode a value.
+ *
+ * @param object An `NSDictionary`, `NSArray`, `NSString`, `NSNumber`, `NSData`, `NSDate` or `NSNull`, containing only those.
+ * @param format The format to produce.
+ * @param error On failure, the reason.
+ *
+ * @return The encoded data, or `nil` on failure.
+ */
++ (NSData *)dataWithObject:(id)object
+                    format:(LFBinarySerializationFormat)format
+                     error:(NSError **)error;
+
+@end
@@ -0,0 +1,772 @@
+//
+//  LFBinarySerialization.m
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "LFBinarySerialization.h"
+
+#import <math.h>
+
+NSString * const LFBinarySerializationErrorDomain = @"LFBinarySerializationErrorDomain";
+
+static NSUInteger const LFBinarySerializationMaximumDepth = 512;
+
+// Below these lengths copying is cheaper than setting up a slice that retains the input.
+static size_t const LFBinarySerializationMinimumNoCopyStringLength = 16;
+static size_t const LFBinarySerializationMinimumNoCopyDataLength = 64;
+
+static int8_t const LFMessagePackTimestampType = -1;
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+    size_t position;
+    NSUInteger depth;
+    BOOL noCopy;
+    __unsafe_unretained NSData *owner;
+    CFAllocatorRef contentsDeallocator;
+    LFBinarySerializationError errorCode;
+} LFBinaryReader;
+
+#pragma mark -
+#pragma mark No-copy support
+
+// Strings created with CFStringCreateWithBytesNoCopy only hold on to their contents deallocator, so use an allocator whose
+// context retains the input: every sliced string keeps the allocator, and with it the input, alive.
+
+static const void *LFBinaryAllocatorRetain(const void *info) {
+    return CFRetain(info);
+}
+
+static void LFBinaryAllocatorRelease(const void *info) {
+    CFRelease(info);
+}
+
+static void LFBinaryAllocatorDeallocate(void *ptr, void *info) {
+    // The bytes belong to the input data, which is released along with the allocator.
+}
+
+static CFAllocatorRef LFBinaryCreateContentsDeallocator(NSData *owner) {
+    CFAllocatorContext context = {0, (__bridge void *)owner, LFBinaryAllocatorRetain, LFBinaryAllocatorRelease, NULL, NULL, NULL, LFBinaryAllocatorDeallocate, NULL};
+    return CFAllocatorCreate(kCFAllocatorDefault, &context);
+}
+
+#pragma mark -
+#pragma mark Reading primitives
+
+static BOOL LFBinaryReadBytes(LFBinaryReader *reader, size_t length, const uint8_t **bytes) {
+    if (reader->length - reader->position < length) {
+        reader->errorCode = LFBinarySerializationErrorTruncated;
+        return NO;
+    }
+    *bytes = reader->bytes + reader->position;
+    reader->position += length;
+    return YES;
+}
+
+static BOOL LFBinaryReadUInt(LFBinaryReader *reader, size_t width, uint64_t *value) {
+    const uint8_t *bytes = NULL;
+    if (!LFBinaryReadBytes(reader, width, &bytes)) {
+        return NO;
+    }
+    uint64_t result = 0;
+    for (size_t i = 0; i < width; i++) {
+        result = (result << 8) | bytes[i];
+    }
+    *value = result;
+    return YES;
+}
+
+static float LFBinaryFloatFromBits(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static double LFBinaryDoubleFromBits(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static double LFBinaryDoubleFromHalf(uint16_t half) {
+    int exponent = (half >> 10) & 0x1f;
+    int mantissa = half & 0x3ff;
+    double value;
+    if (0 == exponent) {
+        value = ldexp(mantissa, -24);
+    } else if (31 != exponent) {
+        value = ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        value = mantissa ? NAN : INFINITY;
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+static id LFBinaryMakeString(LFBinaryReader *reader, const uint8_t *bytes, size_t length) {
+    NSString *string = nil;
+    if (reader->noCopy && length >= LFBinarySerializationMinimumNoCopyStringLength) {
+        string = CFBridgingRelease(CFStringCreateWithBytesNoCopy(kCFAllocatorDefault, bytes, (CFIndex)length, kCFStringEncodingUTF8, false, reader->contentsDeallocator));
+    } else {
+        string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+    }
+    if (!string) {
+        reader->errorCode = LFBinarySerializationErrorMalformed;
+    }
+    return string;
+}
+
+static id LFBinaryMakeData(LFBinaryReader *reader, const uint8_t *bytes, size_t length) {
+    if (reader->noCopy && length >= LFBinarySerializationMinimumNoCopyDataLength) {
+        NSData *owner = reader->owner;
+        return [[NSData alloc] initWithBytesNoCopy:(void *)bytes length:length deallocator:^(void *slice, NSUInteger sliceLength) {
+            (void)owner;
+        }];
+    }
+    return [NSData dataWithBytes:bytes length:length];
+}
+
+static BOOL LFBinaryEnterContainer(LFBinaryReader *reader, uint64_t count) {
+    // Every element takes at least one byte, which bounds counts before anything is allocated for them.
+    if (count > reader->length - reader->position) {
+        reader->errorCode = LFBinarySerializationErrorTruncated;
+        return NO;
+    }
+    if (++reader->depth > LFBinarySerializationMaximumDepth) {
+        reader->errorCode = LFBinarySerializationErrorTooDeep;
+        return NO;
+    }
+    return YES;
+}
+
+#pragma mark -
+#pragma mark MessagePack decoding
+
+static id LFMessagePackRead(LFBinaryReader *reader);
+
+static id LFMessagePackReadArray(LFBinaryReader *reader, uint64_t count) {
+    if (!LFBinaryEnterContainer(reader, count)) {
+        return nil;
+    }
+    NSMutableArray *array = [NSMutableArray arrayWithCapacity:(NSUInteger)count];
+    for (uint64_t i = 0; i < count; i++) {
+        id object = LFMessagePackRead(reader);
+        if (!object) {
+            return nil;
+        }
+        [array addObject:object];
+    }
+    reader->depth--;
+    return array;
+}
+
+static id LFMessagePackReadMap(LFBinaryReader *reader, uint64_t count) {
+    if (!LFBinaryEnterContainer(reader, count)) {
+        return nil;
+    }
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:(NSUInteger)count];
+    for (uint64_t i = 0; i < count; i++) {
+        id key = LFMessagePackRead(reader);
+        id object = key ? LFMessagePackRead(reader) : nil;
+        if (!object) {
+            return nil;
+        }
+        dictionary[key] = object;
+    }
+    reader->depth--;
+    return dictionary;
+}
+
+static id LFMessagePackReadExtension(LFBinaryReader *reader, uint64_t length) {
+    const uint8_t *typeByte = NULL;
+    const uint8_t *bytes = NULL;
+    if (!LFBinaryReadBytes(reader, 1, &typeByte) || !LFBinaryReadBytes(reader, (size_t)length, &bytes)) {
+        return nil;
+    }
+    
+    if ((int8_t)*typeByte != LFMessagePackTimestampType) {
+        return LFBinaryMakeData(reader, bytes, (size_t)length);
+    }
+    
+    LFBinaryReader payload = {bytes, (size_t)length, 0, 0, NO, nil, NULL, 0};
+    uint64_t seconds = 0, nanoseconds = 0;
+    
+    switch (length) {
+        case 4:
+            LFBinaryReadUInt(&payload, 4, &seconds);
+            return [NSDate dateWithTimeIntervalSince1970:(double)seconds];
+        case 8: {
+            uint64_t value = 0;
+            LFBinaryReadUInt(&payload, 8, &value);
+            nanoseconds = value >> 34;
+            seconds = value & 0x3ffffffffull;
+            return [NSDate dateWithTimeIntervalSince1970:(double)seconds + nanoseconds / 1e9];
+        }
+        case 12:
+            LFBinaryReadUInt(&payload, 4, &nanoseconds);
+            LFBinaryReadUInt(&payload, 8, &seconds);
+            return [NSDate dateWithTimeIntervalSince1970:(double)(int64_t)seconds + nanoseconds / 1e9];
+        default:
+            reader->errorCode = LFBinarySerializationErrorMalformed;
+            return nil;
+    }
+}
+
+static id LFMessagePackRead(LFBinaryReader *reader) {
+    
+    const uint8_t *bytes = NULL;
+    if (!LFBinaryReadBytes(reader, 1, &bytes)) {
+        return nil;
+    }
+    
+    uint8_t type = *bytes;
+    uint64_t value = 0;
+    
+    if (type <= 0x7f) {
+        return @(type);
+    } else if (type >= 0xe0) {
+        return @((int8_t)type);
+    } else if (type <= 0x8f) {
+        return LFMessagePackReadMap(reader, type & 0x0f);
+    } else if (type <= 0x9f) {
+        return LFMessagePackReadArray(reader, type & 0x0f);
+    } else if (type <= 0xbf) {
+        value = type & 0x1f;
+        return LFBinaryReadBytes(reader, (size_t)value, &bytes) ? LFBinaryMakeString(reader, bytes, (size_t)value) : nil;
+    }
+    
+    switch (type) {
+        case 0xc0:
+            return [NSNull null];
+        case 0xc2:
+            return @NO;
+        case 0xc3:
+            return @YES;
+        case 0xc4:
+        case 0xc5:
+        case 0xc6:
+            if (!LFBinaryReadUInt(reader, 1 << (type - 0xc4), &value) || !LFBinaryReadBytes(reader, (size_t)value, &bytes)) {
+                return nil;
+            }
+            return LFBinaryMakeData(reader, bytes, (size_t)value);
+        case 0xc7:
+        case 0xc8:
+        case 0xc9:
+            return LFBinaryReadUInt(reader, 1 << (type - 0xc7), &value) ? LFMessagePackReadExtension(reader, value) : nil;
+        case 0xca:
+            return LFBinaryReadUInt(reader, 4, &value) ? @(LFBinaryFloatFromBits((uint32_t)value)) : nil;
+        case 0xcb:
+            return LFBinaryReadUInt(reader, 8, &value) ? @(LFBinaryDoubleFromBits(value)) : nil;
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            return LFBinaryReadUInt(reader, 1 << (type - 0xcc), &value) ? @(value) : nil;
+        case 0xd0:
+            return LFBinaryReadUInt(reader, 1, &value) ? @((int8_t)value) : nil;
+        case 0xd1:
+            return LFBinaryReadUInt(reader, 2, &value) ? @((int16_t)value) : nil;
+        case 0xd2:
+            return LFBinaryReadUInt(reader, 4, &value) ? @((int32_t)value) : nil;
+        case 0xd3:
+            return LFBinaryReadUInt(reader, 8, &value) ? @((int64_t)value) : nil;
+        case 0xd4:
+        case 0xd5:
+        case 0xd6:
+        case 0xd7:
+        case 0xd8:
+            return LFMessagePackReadExtension(reader, 1 << (type - 0xd4));
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+            if (!LFBinaryReadUInt(reader, 1 << (type - 0xd9), &value) || !LFBinaryReadBytes(reader, (size_t)value, &bytes)) {
+                return nil;
+            }
+            return LFBinaryMakeString(reader, bytes, (size_t)value);
+        case 0xdc:
+        case 0xdd:
+            return LFBinaryReadUInt(reader, 2 << (type - 0xdc), &value) ? LFMessagePackReadArray(reader, value) : nil;
+        case 0xde:
+        case 0xdf:
+            return LFBinaryReadUInt(reader, 2 << (type - 0xde), &value) ? LFMessagePackReadMap(reader, value) : nil;
+        default:
+            reader->errorCode = LFBinarySerializationErrorMalformed;
+            return nil;
+    }
+}
+
+#pragma mark -
+#pragma mark CBOR decoding
+
+static uint8_t const LFCBORBreak = 0xff;
+static uint8_t const LFCBORIndefinite = 31;
+
+static id LFCBORRead(LFBinaryReader *reader);
+
+static BOOL LFCBORReadArgument(LFBinaryReader *reader, uint8_t info, uint64_t *value) {
+    if (info < 24) {
+        *value = info;
+        return YES;
+    }
+    if (info <= 27) {
+        return LFBinaryReadUInt(reader, 1 << (info - 24), value);
+    }
+    reader->errorCode = LFBinarySerializationErrorMalformed;
+    return NO;
+}
+
+static BOOL LFCBORReadBreak(LFBinaryReader *reader) {
+    if (reader->position < reader->length && reader->bytes[reader->position] == LFCBORBreak) {
+        reader->position++;
+        return YES;
+    }
+    return NO;
+}
+
+static id LFCBORReadIndefiniteString(LFBinaryReader *reader, uint8_t majorType) {
+    
+    // Chunked strings are rare, so just concatenate the chunks into a copy.
+    NSMutableData *data = [NSMutableData data];
+    
+    while (!LFCBORReadBreak(reader)) {
+        const uint8_t *bytes = NULL;
+        uint64_t length = 0;
+        if (!LFBinaryReadBytes(reader, 1, &bytes)) {
+            return nil;
+        }
+        if ((*bytes >> 5) != majorType || (*bytes & 0x1f) == LFCBORIndefinite) {
+            reader->errorCode = LFBinarySerializationErrorMalformed;
+            return nil;
+        }
+        if (!LFCBORReadArgument(reader, *bytes & 0x1f, &length) || !LFBinaryReadBytes(reader, (size_t)length, &bytes)) {
+            return nil;
+        }
+        [data appendBytes:bytes length:(NSUInteger)length];
+    }
+    
+    if (2 == majorType) {
+        return data;
+    }
+    
+    NSString *string = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    if (!string) {
+        reader->errorCode = LFBinarySerializationErrorMalformed;
+    }
+    return string;
+}
+
+static id LFCBORReadArray(LFBinaryReader *reader, uint64_t count, BOOL indefinite) {
+    if (!LFBinaryEnterContainer(reader, indefinite ? 0 : count)) {
+        return nil;
+    }
+    NSMutableArray *array = [NSMutableArray arrayWithCapacity:indefinite ? 0 : (NSUInteger)count];
+    for (uint64_t i = 0; indefinite ? !LFCBORReadBreak(reader) : i < count; i++) {
+        id object = LFCBORRead(reader);
+        if (!object) {
+            return nil;
+        }
+        [array addObject:object];
+    }
+    reader->depth--;
+    return array;
+}
+
+static id LFCBORReadMap(LFBinaryReader *reader, uint64_t count, BOOL indefinite) {
+    if (!LFBinaryEnterContainer(reader, indefinite ? 0 : count)) {
+        return nil;
+    }
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:indefinite ? 0 : (NSUInteger)count];
+    for (uint64_t i = 0; indefinite ? !LFCBORReadBreak(reader) : i < count; i++) {
+        id key = LFCBORRead(reader);
+        id object = key ? LFCBORRead(reader) : nil;
+        if (!object) {
+            return nil;
+        }
+        dictionary[key] = object;
+    }
+    reader->depth--;
+    return dictionary;
+}
+
+static id LFCBORRead(LFBinaryReader *reader) {
+    
+    const uint8_t *bytes = NULL;
+    if (!LFBinaryReadBytes(reader, 1, &bytes)) {
+        return nil;
+    }
+    
+    uint8_t majorType = *bytes >> 5;
+    uint8_t info = *bytes & 0x1f;
+    uint64_t value = 0;
+    
+    if (LFCBORIndefinite == info) {
+        switch (majorType) {
+            case 2:
+            case 3:
+                return LFCBORReadIndefiniteString(reader, majorType);
+            case 4:
+                return LFCBORReadArray(reader, 0, YES);
+            case 5:
+                return LFCBORReadMap(reader, 0, YES);
+            default:
+                // Includes a stray break.
+                reader->errorCode = LFBinarySerializationErrorMalformed;
+                return nil;
+        }
+    }
+    
+    if (7 == majorType) {
+        switch (info) {
+            case 20:
+                return @NO;
+            case 21:
+                return @YES;
+            case 22:
+            case 23:
+                return [NSNull null];
+            case 25:
+                return LFBinaryReadUInt(reader, 2, &value) ? @(LFBinaryDoubleFromHalf((uint16_t)value)) : nil;
+            case 26:
+                return LFBinaryReadUInt(reader, 4, &value) ? @(LFBinaryFloatFromBits((uint32_t)value)) : nil;
+            case 27:
+                return LFBinaryReadUInt(reader, 8, &value) ? @(LFBinaryDoubleFromBits(value)) : nil;
+            default:
+                // Unassigned simple values.
+                return LFCBORReadArgument(reader, info, &value) ? @(value) : nil;
+        }
+    }
+    
+    if (!LFCBORReadArgument(reader, info, &value)) {
+        return nil;
+    }
+    
+    switch (majorType) {
+        case 0:
+            return @(value);
+        case 1:
+            return value <= INT64_MAX ? @(-1 - (int64_t)value) : @(-1.0 - (double)value);
+        case 2:
+            return LFBinaryReadBytes(reader, (size_t)value, &bytes) ? LFBinaryMakeData(reader, bytes, (size_t)value) : nil;
+        case 3:
+            return LFBinaryReadBytes(reader, (size_t)value, &bytes) ? LFBinaryMakeString(reader, bytes, (size_t)value) : nil;
+        case 4:
+            return LFCBORReadArray(reader, value, NO);
+        case 5:
+            return LFCBORReadMap(reader, value, NO);
+        default: {
+            // Tags: epoch-based date times become NSDate, anything else decodes to its content.
+            if (++reader->depth > LFBinarySerializationMaximumDepth) {
+                reader->errorCode = LFBinarySerializationErrorTooDeep;
+                return nil;
+            }
+            id content = LFCBORRead(reader);
+            reader->depth--;
+            if (1 == value && [content isKindOfClass:[NSNumber class]]) {
+                return [NSDate dateWithTimeIntervalSince1970:[content doubleValue]];
+            }
+            return content;
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Encoding primitives
+
+static void LFBinaryAppendByte(NSMutableData *data, uint8_t byte) {
+    [data appendBytes:&byte length:1];
+}
+
+static void LFBinaryAppendUInt(NSMutableData *data, uint64_t value, size_t width) {
+    uint8_t bytes[8];
+    for (size_t i = 0; i < width; i++) {
+        bytes[i] = (uint8_t)(value >> (8 * (width - 1 - i)));
+    }
+    [data appendBytes:bytes length:width];
+}
+
+static void LFMessagePackAppendUInt(NSMutableData *data, uint64_t value) {
+    if (value <= 0x7f) {
+        LFBinaryAppendByte(data, (uint8_t)value);
+    } else if (value <= UINT8_MAX) {
+        LFBinaryAppendByte(data, 0xcc);
+        LFBinaryAppendUInt(data, value, 1);
+    } else if (value <= UINT16_MAX) {
+        LFBinaryAppendByte(data, 0xcd);
+        LFBinaryAppendUInt(data, value, 2);
+    } else if (value <= UINT32_MAX) {
+        LFBinaryAppendByte(data, 0xce);
+        LFBinaryAppendUInt(data, value, 4);
+    } else {
+        LFBinaryAppendByte(data, 0xcf);
+        LFBinaryAppendUInt(data, value, 8);
+    }
+}
+
+static void LFMessagePackAppendInt(NSMutableData *data, int64_t value) {
+    if (value >= 0) {
+        LFMessagePackAppendUInt(data, (uint64_t)value);
+    } else if (value >= -32) {
+        LFBinaryAppendByte(data, (uint8_t)(int8_t)value);
+    } else if (value >= INT8_MIN) {
+        LFBinaryAppendByte(data, 0xd0);
+        LFBinaryAppendUInt(data, (uint64_t)value, 1);
+    } else if (value >= INT16_MIN) {
+        LFBinaryAppendByte(data, 0xd1);
+        LFBinaryAppendUInt(data, (uint64_t)value, 2);
+    } else if (value >= INT32_MIN) {
+        LFBinaryAppendByte(data, 0xd2);
+        LFBinaryAppendUInt(data, (uint64_t)value, 4);
+    } else {
+        LFBinaryAppendByte(data, 0xd3);
+        LFBinaryAppendUInt(data, (uint64_t)value, 8);
+    }
+}
+
+/** Append a MessagePack length header. `fixType` is 0 for types without a fix form; `type8` is 0 for types without an 8-bit form. */
+static void LFMessagePackAppendLength(NSMutableData *data, NSUInteger length, uint8_t fixType, NSUInteger fixMaximum, uint8_t type8, uint8_t type16, uint8_t type32) {
+    if (fixType && length <= fixMaximum) {
+        LFBinaryAppendByte(data, fixType | (uint8_t)length);
+    } else if (type8 && length <= UINT8_MAX) {
+        LFBinaryAppendByte(data, type8);
+        LFBinaryAppendUInt(data, length, 1);
+    } else if (length <= UINT16_MAX) {
+        LFBinaryAppendByte(data, type16);
+        LFBinaryAppendUInt(data, length, 2);
+    } else {
+        LFBinaryAppendByte(data, type32);
+        LFBinaryAppendUInt(data, length, 4);
+    }
+}
+
+static void LFCBORAppendHead(NSMutableData *data, uint8_t majorType, uint64_t value) {
+    uint8_t type = (uint8_t)(majorType << 5);
+    if (value < 24) {
+        LFBinaryAppendByte(data, type | (uint8_t)value);
+    } else if (value <= UINT8_MAX) {
+        LFBinaryAppendByte(data, type | 24);
+        LFBinaryAppendUInt(data, value, 1);
+    } else if (value <= UINT16_MAX) {
+        LFBinaryAppendByte(data, type | 25);
+        LFBinaryAppendUInt(data, value, 2);
+    } else if (value <= UINT32_MAX) {
+        LFBinaryAppendByte(data, type | 26);
+        LFBinaryAppendUInt(data, value, 4);
+    } else {
+        LFBinaryAppendByte(data, type | 27);
+        LFBinaryAppendUInt(data, value, 8);
+    }
+}
+
+#pragma mark -
+#pragma mark Encoding
+
+static BOOL LFBinaryAppendObject(NSMutableData *data, id object, LFBinarySerializationFormat format, NSUInteger depth, LFBinarySerializationError *errorCode) {
+    
+    BOOL messagePack = (LFBinarySerializationFormatMessagePack == format);
+    
+    if (depth > LFBinarySerializationMaximumDepth) {
+        *errorCode = LFBinarySerializationErrorTooDeep;
+        return NO;
+    }
+    
+    if ([object isKindOfClass:[NSString class]]) {
+        NSString *string = object;
+        NSUInteger length = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        if (messagePack) {
+            LFMessagePackAppendLength(data, length, 0xa0, 31, 0xd9, 0xda, 0xdb);
+        } else {
+            LFCBORAppendHead(data, 3, length);
+        }
+        NSUInteger offset = [data length];
+        [data increaseLengthBy:length];
+        [string getBytes:(uint8_t *)[data mutableBytes] + offset maxLength:length usedLength:NULL encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, [string length]) remainingRange:NULL];
+        
+    } else if ([object isKindOfClass:[NSNumber class]]) {
+        NSNumber *number = object;
+        const char *objCType = [number objCType];
+        if (CFGetTypeID((__bridge CFTypeRef)number) == CFBooleanGetTypeID()) {
+            LFBinaryAppendByte(data, messagePack ? ([number boolValue] ? 0xc3 : 0xc2) : ([number boolValue] ? 0xf5 : 0xf4));
+        } else if (0 == strcmp(objCType, @encode(float))) {
+            float value = [number floatValue];
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            LFBinaryAppendByte(data, messagePack ? 0xca : 0xfa);
+            LFBinaryAppendUInt(data, bits, 4);
+        } else if (0 == strcmp(objCType, @encode(double))) {
+            double value = [number doubleValue];
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            LFBinaryAppendByte(data, messagePack ? 0xcb : 0xfb);
+            LFBinaryAppendUInt(data, bits, 8);
+        } else if (0 == strcmp(objCType, @encode(unsigned long long)) && [number unsignedLongLongValue] > INT64_MAX) {
+            if (messagePack) {
+                LFMessagePackAppendUInt(data, [number unsignedLongLongValue]);
+            } else {
+                LFCBORAppendHead(data, 0, [number unsignedLongLongValue]);
+            }
+        } else {
+            long long value = [number longLongValue];
+            if (messagePack) {
+                LFMessagePackAppendInt(data, value);
+            } else if (value >= 0) {
+                LFCBORAppendHead(data, 0, (uint64_t)value);
+            } else {
+                LFCBORAppendHead(data, 1, (uint64_t)(-1 - value));
+            }
+        }
+        
+    } else if ([object isKindOfClass:[NSDictionary class]]) {
+        NSDictionary *dictionary = object;
+        if (messagePack) {
+            LFMessagePackAppendLength(data, [dictionary count], 0x80, 15, 0, 0xde, 0xdf);
+        } else {
+            LFCBORAppendHead(data, 5, [dictionary count]);
+        }
+        __block BOOL success = YES;
+        [dictionary enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            success = LFBinaryAppendObject(data, key, format, depth + 1, errorCode) && LFBinaryAppendObject(data, value, format, depth + 1, errorCode);
+            *stop = !success;
+        }];
+        return success;
+        
+    } else if ([object isKindOfClass:[NSArray class]]) {
+        NSArray *array = object;
+        if (messagePack) {
+            LFMessagePackAppendLength(data, [array count], 0x90, 15, 0, 0xdc, 0xdd);
+        } else {
+            LFCBORAppendHead(data, 4, [array count]);
+        }
+        for (id element in array) {
+            if (!LFBinaryAppendObject(data, element, format, depth + 1, errorCode)) {
+                return NO;
+            }
+        }
+        
+    } else if ([object isKindOfClass:[NSData class]]) {
+        NSData *bytes = object;
+        if (messagePack) {
+            LFMessagePackAppendLength(data, [bytes length], 0, 0, 0xc4, 0xc5, 0xc6);
+        } else {
+            LFCBORAppendHead(data, 2, [bytes length]);
+        }
+        [data appendData:bytes];
+        
+    } else if ([object isKindOfClass:[NSDate class]]) {
+        NSTimeInterval interval = [object timeIntervalSince1970];
+        if (!messagePack) {
+            uint64_t bits;
+            memcpy(&bits, &interval, sizeof(bits));
+            LFCBORAppendHead(data, 6, 1);
+            LFBinaryAppendByte(data, 0xfb);
+            LFBinaryAppendUInt(data, bits, 8);
+            return YES;
+        }
+        double seconds = floor(interval);
+        uint64_t nanoseconds = (uint64_t)llround((interval - seconds) * 1e9);
+        if (nanoseconds >= 1000000000ull) {
+            seconds += 1;
+            nanoseconds -= 1000000000ull;
+        }
+        if (seconds >= 0 && seconds < (double)(1ull << 34)) {
+            if (0 == nanoseconds && seconds <= UINT32_MAX) {
+                LFBinaryAppendByte(data, 0xd6);
+                LFBinaryAppendByte(data, (uint8_t)LFMessagePackTimestampType);
+                LFBinaryAppendUInt(data, (uint64_t)seconds, 4);
+            } else {
+                LFBinaryAppendByte(data, 0xd7);
+                LFBinaryAppendByte(data, (uint8_t)LFMessagePackTimestampType);
+                LFBinaryAppendUInt(data, (nanoseconds << 34) | (uint64_t)seconds, 8);
+            }
+        } else {
+            LFBinaryAppendByte(data, 0xc7);
+            LFBinaryAppendByte(data, 12);
+            LFBinaryAppendByte(data, (uint8_t)LFMessagePackTimestampType);
+            LFBinaryAppendUInt(data, nanoseconds, 4);
+            LFBinaryAppendUInt(data, (uint64_t)(int64_t)seconds, 8);
+        }
+        
+    } else if ([object isKindOfClass:[NSNull class]]) {
+        LFBinaryAppendByte(data, messagePack ? 0xc0 : 0xf6);
+        
+    } else {
+        *errorCode = LFBinarySerializationErrorUnsupportedObject;
+        return NO;
+    }
+    
+    return YES;
+}
+
+#pragma mark -
+
+@implementation LFBinarySerialization
+
++ (id)objectWithData:(NSData *)data
+              format:(LFBinarySerializationFormat)format
+             options:(LFBinaryReadingOptions)options
+               error:(NSError **)error {
+    
+    NSParameterAssert(data);
+    
+    LFBinaryReader reader = {[data bytes], [data length], 0, 0, (options & LFBinaryReadingNoCopy) != 0, data, NULL, 0};
+    if (reader.noCopy) {
+        reader.contentsDeallocator = LFBinaryCreateContentsDeallocator(data);
+    }
+    
+    id object = (LFBinarySerializationFormatCBOR == format) ? LFCBORRead(&reader) : LFMessagePackRead(&reader);
+    
+    if (reader.contentsDeallocator) {
+        CFRelease(reader.contentsDeallocator);
+    }
+    
+    if (object && reader.position != reader.length) {
+        object = nil;
+        reader.errorCode = LFBinarySerializationErrorTrailingData;
+    }
+    
+    if (!object && error) {
+        *error = [NSError errorWithDomain:LFBinarySerializationErrorDomain code:reader.errorCode ?: LFBinarySerializationErrorMalformed userInfo:@{@"offset": @(reader.position)}];
+    }
+    
+    return object;
+}
+
++ (NSData *)dataWithObject:(id)object
+                    format:(LFBinarySerializationFormat)format
+                     error:(NSError **)error {
+    
+    NSParameterAssert(object);
+    
+    NSMutableData *data = [NSMutableData data];
+    LFBinarySerializationError errorCode = 0;
+    
+    if (!LFBinaryAppendObject(data, object, format, 0, &errorCode)) {
+        if (error) {
+            *error = [NSError errorWithDomain:LFBinarySerializationErrorDomain code:errorCode userInfo:nil];
+        }
+        return nil;
+    }
+    
+    return data;
+}
+
+@end
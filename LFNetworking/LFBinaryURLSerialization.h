@@ -0,0 +1,77 @@
+//
+//  LFBinaryURLSerialization.h
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+#import "AFURLRequestSerialization.h"
+#import "AFURLResponseSerialization.h"
+#import "LFBinarySerialization.h"
+
+/** `LFBinaryRequestSerializer` is a subclass of `AFHTTPRequestSerializer` that encodes parameters as MessagePack or CBOR.
+ *
+ * It also sets an `Accept` header preferring `format`, then the other binary format, then JSON, so that servers able to
+ * answer in a binary format do so. Pair it with `<LFBinaryResponseSerializer>`, which decodes whichever one comes back.
+ */
+
+@interface LFBinaryRequestSerializer : AFHTTPRequestSerializer
+
+/** The format request bodies are encoded in and that the `Accept` header prefers. Defaults to MessagePack. */
+@property (nonatomic, assign) LFBinarySerializationFormat format;
+
+/** Creates and returns a serializer for the specified format.
+ *
+ * @param format The format request bodies are encoded in.
+ */
++ (instancetype)serializerWithFormat:(LFBinarySerializationFormat)format;
+
+@end
+
+/** `LFBinaryResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that decodes MessagePack, CBOR or JSON, depending on the response's `Content-Type`.
+ *
+ * By default it accepts `application/msgpack`, `application/x-msgpack`, `application/vnd.msgpack`, `application/cbor`
+ * and the types accepted by `JSONResponseSerializer`, to which JSON responses are handed.
+ *
+ * Like AFNetworking's serializers, it still decodes the body of a response with an unacceptable status code and returns
+ * it along with the validation error; only an unacceptable content type stops decoding.
+ */
+
+@interface LFBinaryResponseSerializer : AFHTTPResponseSerializer
+
+/** Options for decoding binary responses. Defaults to `LFBinaryReadingNoCopy`.
+ *
+ * Slicing strings and blobs out of the response data is safe because the data is not mutated once it has been handed
+ * to the serializer; clear the option if you use the serializer on data you modify afterwards.
+ */
+@property (nonatomic, assign) LFBinaryReadingOptions readingOptions;
+
+/** The serializer JSON responses are handed to. Defaults to an `AFJSONResponseSerializer`. */
+@property (nonatomic, strong) AFJSONResponseSerializer *JSONResponseSerializer;
+
+/** Creates and returns a serializer with the specified reading options.
+ *
+ * @param readingOptions The options for decoding binary responses.
+ */
++ (instancetype)serializerWithReadingOptions:(LFBinaryReadingOptions)readingOptions;
+
+@end
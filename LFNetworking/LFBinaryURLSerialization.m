@@ -0,0 +1,269 @@
+//
+//  LFBinaryURLSerialization.m
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "LFBinaryURLSerialization.h"
+
+static NSString * const LFMessagePackContentType = @"application/msgpack";
+static NSString * const LFCBORContentType = @"application/cbor";
+
+static NSSet *LFMessagePackContentTypes(void) {
+    static NSSet *contentTypes = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        contentTypes = [NSSet setWithObjects:LFMessagePackContentType, @"application/x-msgpack", @"application/vnd.msgpack", nil];
+    });
+    return contentTypes;
+}
+
+// AFHTTPResponseSerializer reports an unacceptable content type as NSURLErrorCannotDecodeContentData, possibly
+// underneath a status code error.
+static BOOL LFErrorIsUnacceptableContentType(NSError *error) {
+    for (; error; error = error.userInfo[NSUnderlyingErrorKey]) {
+        if ([error.domain isEqualToString:AFURLResponseSerializationErrorDomain] && NSURLErrorCannotDecodeContentData == error.code) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+#pragma mark -
+
+@implementation LFBinaryRequestSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithFormat:LFBinarySerializationFormatMessagePack];
+}
+
++ (instancetype)serializerWithFormat:(LFBinarySerializationFormat)format {
+    LFBinaryRequestSerializer *serializer = [[self alloc] init];
+    serializer.format = format;
+    return serializer;
+}
+
+- (instancetype)init {
+    
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    
+    self.format = LFBinarySerializationFormatMessagePack;
+    
+    return self;
+}
+
+- (void)setFormat:(LFBinarySerializationFormat)format {
+    _format = format;
+    
+    if (LFBinarySerializationFormatCBOR == format) {
+        [self setValue:@"application/cbor, application/msgpack;q=0.9, application/json;q=0.5" forHTTPHeaderField:@"Accept"];
+    } else {
+        [self setValue:@"application/msgpack, application/cbor;q=0.9, application/json;q=0.5" forHTTPHeaderField:@"Accept"];
+    }
+}
+
+#pragma mark - AFURLRequestSerialization
+
+- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
+                               withParameters:(id)parameters
+                                        error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(request);
+    
+    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
+        return [super requestBySerializingRequest:request withParameters:parameters error:error];
+    }
+    
+    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+    
+    [self.HTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
+        if (![request valueForHTTPHeaderField:field]) {
+            [mutableRequest setValue:value forHTTPHeaderField:field];
+        }
+    }];
+    
+    if (parameters) {
+        NSData *body = [LFBinarySerialization dataWithObject:parameters format:self.format error:error];
+        if (!body) {
+            return nil;
+        }
+        
+        if (![mutableRequest valueForHTTPHeaderField:@"Content-Type"]) {
+            [mutableRequest setValue:(LFBinarySerializationFormatCBOR == self.format ? LFCBORContentType : LFMessagePackContentType) forHTTPHeaderField:@"Content-Type"];
+        }
+        
+        [mutableRequest setHTTPBody:body];
+    }
+    
+    return mutableRequest;
+}
+
+#pragma mark - NSSecureCoding
+
+- (id)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+    
+    self.format = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(format))] integerValue];
+    
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+    
+    [coder encodeObject:@(self.format) forKey:NSStringFromSelector(@selector(format))];
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    LFBinaryRequestSerializer *serializer = [super copyWithZone:zone];
+    serializer.format = self.format;
+    
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+@implementation LFBinaryResponseSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithReadingOptions:LFBinaryReadingNoCopy];
+}
+
++ (instancetype)serializerWithReadingOptions:(LFBinaryReadingOptions)readingOptions {
+    LFBinaryResponseSerializer *serializer = [[self alloc] init];
+    serializer.readingOptions = readingOptions;
+    return serializer;
+}
+
+- (instancetype)init {
+    
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    
+    self.readingOptions = LFBinaryReadingNoCopy;
+    self.JSONResponseSerializer = [AFJSONResponseSerializer serializer];
+    
+    return self;
+}
+
+- (void)setJSONResponseSerializer:(AFJSONResponseSerializer *)JSONResponseSerializer {
+    _JSONResponseSerializer = JSONResponseSerializer;
+    
+    NSMutableSet *acceptableContentTypes = [NSMutableSet setWithSet:LFMessagePackContentTypes()];
+    [acceptableContentTypes addObject:LFCBORContentType];
+    if (JSONResponseSerializer.acceptableContentTypes) {
+        [acceptableContentTypes unionSet:JSONResponseSerializer.acceptableContentTypes];
+    }
+    self.acceptableContentTypes = acceptableContentTypes;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    // As with AFNetworking's own serializers, only a content type we can't read stops decoding; the body of a
+    // response with an error status is still decoded, so the caller gets the server's error payload.
+    NSError *validationError = nil;
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:&validationError]) {
+        if (LFErrorIsUnacceptableContentType(validationError)) {
+            if (error) *error = validationError;
+            return nil;
+        }
+    }
+    
+    NSString *MIMEType = [[response MIMEType] lowercaseString];
+    LFBinarySerializationFormat format;
+    
+    if ([LFMessagePackContentTypes() containsObject:MIMEType]) {
+        format = LFBinarySerializationFormatMessagePack;
+    } else if ([MIMEType isEqualToString:LFCBORContentType]) {
+        format = LFBinarySerializationFormatCBOR;
+    } else {
+        return [self.JSONResponseSerializer responseObjectForResponse:response data:data error:error];
+    }
+    
+    if (![data length]) {
+        if (error) *error = validationError;
+        return nil;
+    }
+    
+    NSError *serializationError = nil;
+    id responseObject = [LFBinarySerialization objectWithData:data format:format options:self.readingOptions error:&serializationError];
+    
+    if (serializationError && validationError) {
+        NSMutableDictionary *userInfo = [serializationError.userInfo mutableCopy] ?: [NSMutableDictionary dictionary];
+        userInfo[NSUnderlyingErrorKey] = validationError;
+        serializationError = [NSError errorWithDomain:serializationError.domain code:serializationError.code userInfo:userInfo];
+    }
+    
+    if (error) *error = serializationError ?: validationError;
+    
+    return responseObject;
+}
+
+#pragma mark - NSSecureCoding
+
+- (id)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+    
+    self.readingOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(readingOptions))] unsignedIntegerValue];
+    // Assign the ivar, the setter would overwrite the decoded acceptableContentTypes.
+    _JSONResponseSerializer = [decoder decodeObjectOfClass:[AFJSONResponseSerializer class] forKey:NSStringFromSelector(@selector(JSONResponseSerializer))] ?: [AFJSONResponseSerializer serializer];
+    
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+    
+    [coder encodeObject:@(self.readingOptions) forKey:NSStringFromSelector(@selector(readingOptions))];
+    [coder encodeObject:self.JSONResponseSerializer forKey:NSStringFromSelector(@selector(JSONResponseSerializer))];
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    LFBinaryResponseSerializer *serializer = [super copyWithZone:zone];
+    serializer.readingOptions = self.readingOptions;
+    serializer->_JSONResponseSerializer = [self.JSONResponseSerializer copyWithZone:zone];
+    
+    return serializer;
+}
+
+@end
@@ -154,4 +154,21 @@
                             success:(void (^)(LFNetworkDataTaskOperation *operation, id responseObject))success
                             failure:(void (^)(LFNetworkDataTaskOperation *operation, NSError *error))failure;
 
+/**
+ Creates and runs a request, returning a promise for the serialized response.
+ 
+ @param method The HTTP method, e.g. `GET` or `POST`.
+ @param urlString The URL string used to create the request URL.
+ @param parameters The parameters to be encoded according to the client request serializer.
+ 
+ @return An `LFPromise` fulfilled with the response object created by the client response serializer, or rejected with the network, validation or parsing error.
+ 
+ @note The response is serialized and the promise settled on the session's delegate queue, so continuations that issue dependent requests start them immediately. Use `-[LFPromise done:]` to get the final result on `completionQueue`.
+ 
+ @see -promiseWithRequest:
+ */
+- (LFPromise *)promiseWithHTTPMethod:(NSString *)method
+                           URLString:(NSString *)urlString
+                          parameters:(id)parameters;
+
 @end
@@ -29,6 +29,12 @@
 
 @property (readwrite, nonatomic, strong) NSURL *baseURL;
 
+- (NSMutableURLRequest *)requestWithHTTPMethod:(NSString *)method
+                                     URLString:(NSString *)urlString
+                                    parameters:(id)parameters
+                     constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
+                                         error:(NSError *__autoreleasing *)error;
+
 - (LFNetworkDataTaskOperation *)dataTaskOperationWithHTTPMethod:(NSString *)method
                                                       URLString:(NSString *)urlString
                                                      parameters:(id)parameters
@@ -77,6 +83,28 @@
     return self;
 }
 
+- (NSMutableURLRequest *)requestWithHTTPMethod:(NSString *)method
+                                     URLString:(NSString *)urlString
+                                    parameters:(id)parameters
+                     constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
+                                         error:(NSError *__autoreleasing *)error {
+    
+    NSString *absoluteURLString = [[NSURL URLWithString:urlString relativeToURL:self.baseURL] absoluteString];
+    
+    if (block) {
+        return [self.requestSerializer multipartFormRequestWithMethod:method
+                                                            URLString:absoluteURLString
+                                                           parameters:parameters
+                                            constructingBodyWithBlock:block
+                                                                error:error];
+    }
+    
+    return [self.requestSerializer requestWithMethod:method
+                                           URLString:absoluteURLString
+                                          parameters:parameters
+                                               error:error];
+}
+
 - (LFNetworkDataTaskOperation *)dataTaskOperationWithHTTPMethod:(NSString *)method
                                                       URLString:(NSString *)urlString
                                                      parameters:(id)parameters
@@ -84,22 +112,7 @@
                                                         success:(void (^)(LFNetworkDataTaskOperation *, id))success
                                                         failure:(void (^)(LFNetworkDataTaskOperation *, NSError *))failure {
     NSError *serializationError = nil;
-    NSMutableURLRequest *request = nil;
-    
-    if (block) {
-        
-        request = [self.requestSerializer multipartFormRequestWithMethod:method
-                                                               URLString:[[NSURL URLWithString:urlString relativeToURL:self.baseURL] absoluteString]
-                                                              parameters:parameters
-                                               constructingBodyWithBlock:block
-                                                                   error:&serializationError];
-    } else {
-        
-        request = [self.requestSerializer requestWithMethod:method
-                                                  URLString:[[NSURL URLWithString:urlString relativeToURL:self.baseURL] absoluteString]
-                                                 parameters:parameters
-                                                      error:&serializationError];
-    }
+    NSMutableURLRequest *request = [self requestWithHTTPMethod:method URLString:urlString parameters:parameters constructingBodyWithBlock:block error:&serializationError];
     
     if (serializationError) {
         
@@ -128,7 +141,10 @@
                 
                 if (self.responseSerializer) {
                     NSError *serializationError = nil;
+                    [operation.tracer beginSpan:LFNetworkTraceSerialization identifier:operation.traceIdentifier];
                     id object = [self.responseSerializer responseObjectForResponse:operation.task.response data:data error:&serializationError];
+                    [operation.tracer endSpan:LFNetworkTraceSerialization identifier:operation.traceIdentifier];
+                    [operation.tracer recordEvent:LFNetworkTraceSerialized identifier:operation.traceIdentifier value:(int64_t)[data length]];
                     if (serializationError) {
                         if (failure) {
                             failure(dataTaskOperation, serializationError);
@@ -203,5 +219,52 @@
     return operation;
 }
 
+- (LFPromise *)promiseWithHTTPMethod:(NSString *)method
+                           URLString:(NSString *)urlString
+                          parameters:(id)parameters {
+    
+    NSError *serializationError = nil;
+    NSMutableURLRequest *request = [self requestWithHTTPMethod:method URLString:urlString parameters:parameters constructingBodyWithBlock:nil error:&serializationError];
+    
+    LFPromise *promise = [[LFPromise alloc] init];
+    promise.completionQueue = self.completionQueue;
+    
+    if (serializationError) {
+        [promise reject:serializationError];
+        return promise;
+    }
+    
+    // Serialize on the delegate queue as well, so the value is ready for the next step without another hop.
+    LFNetworkDataTaskOperation *operation = [self dataOperationWithRequest:request progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+        
+        if (error) {
+            [promise reject:error];
+            return;
+        }
+        
+        if (!self.responseSerializer) {
+            [promise fulfill:data];
+            return;
+        }
+        
+        NSError *serializationError = nil;
+        [operation.tracer beginSpan:LFNetworkTraceSerialization identifier:operation.traceIdentifier];
+        id object = [self.responseSerializer responseObjectForResponse:operation.task.response data:data error:&serializationError];
+        [operation.tracer endSpan:LFNetworkTraceSerialization identifier:operation.traceIdentifier];
+        [operation.tracer recordEvent:LFNetworkTraceSerialized identifier:operation.traceIdentifier value:(int64_t)[data length]];
+        
+        if (serializationError) {
+            [promise reject:serializationError];
+        } else {
+            [promise fulfill:object];
+        }
+    }];
+    operation.completesOnDelegateQueue = YES;
+    
+    [promise addCancellableOperation:operation];
+    [self addOperation:operation];
+    
+    return promise;
+}
 
 @end
@@ -0,0 +1,141 @@
+//
+//  LFNetworkArchive.h
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+/** The error domain of errors created by `LFNetworkArchive` and `LFNetworkArchiveWriter`. */
+extern NSString * const LFNetworkArchiveErrorDomain;
+
+typedef NS_ENUM(NSInteger, LFNetworkArchiveError) {
+    /** The file is not an archive, is of an unsupported version, or is truncated. */
+    LFNetworkArchiveErrorCorrupt = 1,
+    /** The writer was already finished. */
+    LFNetworkArchiveErrorFinished = 2,
+};
+
+/** A read-only archive of recorded HTTP responses, as written by `<LFNetworkArchiveWriter>`.
+ *
+ * The file is memory mapped, and response bodies are handed out as slices of the mapping, so serving a response
+ * does not copy or read anything. Responses are looked up by HTTP method and absolute URL; when a request was recorded
+ * more than once, successive lookups cycle through the recorded responses in order.
+ *
+ * The archive format is little-endian: a 24 byte header (`LFNA` magic, version, entry count, index offset), the
+ * entries' keys, headers (as JSON) and bodies, and finally a fixed-size index record per entry.
+ */
+
+@interface LFNetworkArchive : NSObject
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/** The number of recorded responses. */
+@property (nonatomic, readonly) NSUInteger count;
+
+/// --------------------
+/// @name Initialization
+/// --------------------
+
+/** Open an archive.
+ *
+ * @param path The archive file.
+ * @param error On failure, the reason.
+ *
+ * @return Returns `LFNetworkArchive`, or `nil` if the file could not be mapped or is not a valid archive.
+ */
+- (instancetype)initWithContentsOfFile:(NSString *)path error:(NSError **)error;
+
+/// ---------------
+/// @name Lookup
+/// ---------------
+
+/** Return the key a request is archived under: its HTTP method and absolute URL. */
++ (NSString *)keyForRequest:(NSURLRequest *)request;
+
+/** Return whether a response was recorded for `request`. */
+- (BOOL)containsResponseForRequest:(NSURLRequest *)request;
+
+/** Return the next recorded response for `request`.
+ *
+ * @param request The request to look up.
+ * @param data On return, the response body. It references the archive's mapping, which it keeps alive.
+ *
+ * @return The response, with `request`'s URL, or `nil` if none was recorded.
+ */
+- (NSHTTPURLResponse *)responseForRequest:(NSURLRequest *)request data:(NSData **)data;
+
+@end
+
+/** Records HTTP responses into an archive that `<LFNetworkArchive>` can read.
+ *
+ * Either append responses directly, or assign the writer to `<LFURLSessionManager>`'s `archiveWriter` property to capture
+ * every data task the manager's session completes successfully. Call `finish:` to write the index; the archive cannot be
+ * read before that.
+ */
+
+@interface LFNetworkArchiveWriter : NSObject
+
+/** The number of responses appended so far. */
+@property (nonatomic, readonly) NSUInteger count;
+
+/** Create an archive, replacing any existing file.
+ *
+ * @param path The archive file.
+ * @param error On failure, the reason.
+ *
+ * @return Returns `LFNetworkArchiveWriter`, or `nil` if the file could not be created.
+ */
+- (instancetype)initWithPath:(NSString *)path error:(NSError **)error;
+
+/** Append a response.
+ *
+ * @param response The response. `Content-Encoding` is dropped and `Content-Length` rewritten, since `data` is already decoded.
+ * @param data The response body.
+ * @param request The request, which determines the key the response is found under.
+ * @param error On failure, the reason.
+ *
+ * @return `YES` if the response was appended.
+ */
+- (BOOL)appendResponse:(NSHTTPURLResponse *)response data:(NSData *)data forRequest:(NSURLRequest *)request error:(NSError **)error;
+
+/** Write the index and close the file. Responses captured for tasks still in flight are discarded.
+ *
+ * @param error On failure, the reason.
+ *
+ * @return `YES` if the archive was completed.
+ */
+- (BOOL)finish:(NSError **)error;
+
+/// -----------------------------
+/// @name Capturing session tasks
+/// -----------------------------
+
+/** Buffer data received by `task`. Called by `LFURLSessionManager`. */
+- (void)task:(NSURLSessionTask *)task didReceiveData:(NSData *)data;
+
+/** Append the buffered response of `task` if it completed without error. Called by `LFURLSessionManager`. */
+- (void)task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error;
+
+@end
@@ -0,0 +1,420 @@
+//
+//  LFNetworkArchive.m
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "LFNetworkArchive.h"
+
+#import <stdio.h>
+
+NSString * const LFNetworkArchiveErrorDomain = @"LFNetworkArchiveErrorDomain";
+
+static const char LFNetworkArchiveMagic[4] = {'L', 'F', 'N', 'A'};
+static const uint32_t LFNetworkArchiveVersion = 1;
+
+// On-disk layout, all integers little-endian.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t indexOffset;
+} __attribute__((packed)) LFNetworkArchiveHeader;
+
+typedef struct {
+    uint64_t keyOffset;
+    uint32_t keyLength;
+    uint32_t statusCode;
+    uint64_t headersOffset;
+    uint32_t headersLength;
+    uint32_t reserved;
+    uint64_t bodyOffset;
+    uint64_t bodyLength;
+} __attribute__((packed)) LFNetworkArchiveIndexEntry;
+
+static NSError *LFNetworkArchiveCorruptError(NSString *path) {
+    return [NSError errorWithDomain:LFNetworkArchiveErrorDomain code:LFNetworkArchiveErrorCorrupt userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"%@ is not a valid network archive.", path]}];
+}
+
+// NSHTTPURLResponse expects string header names and values; anything else means the file is damaged.
+static BOOL LFNetworkArchiveHeaderFieldsAreValid(NSDictionary *headerFields) {
+    for (id name in headerFields) {
+        if (![name isKindOfClass:[NSString class]] || ![headerFields[name] isKindOfClass:[NSString class]]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+static NSError *LFNetworkArchivePOSIXError(NSString *path) {
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey: path}];
+}
+
+#pragma mark -
+
+/** One archived response, with its headers already parsed. */
+@interface LFNetworkArchiveEntry : NSObject
+
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, strong) NSDictionary *headerFields;
+@property (nonatomic, assign) NSRange bodyRange;
+
+@end
+
+@implementation LFNetworkArchiveEntry
+
+@end
+
+#pragma mark -
+
+@interface LFNetworkArchive ()
+
+@property (nonatomic, strong) NSData *mappedData;
+
+/** Arrays of `LFNetworkArchiveEntry`, keyed by `keyForRequest:`. */
+@property (nonatomic, strong) NSDictionary *entries;
+
+/** The index of the next entry to serve, per key. */
+@property (nonatomic, strong) NSMutableDictionary *cursors;
+
+@end
+
+@implementation LFNetworkArchive
+
+#pragma mark -
+#pragma mark Initialization
+
+- (instancetype)initWithContentsOfFile:(NSString *)path error:(NSError **)error {
+    
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    
+    NSData *mappedData = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:error];
+    if (!mappedData) {
+        return nil;
+    }
+    
+    const uint8_t *bytes = [mappedData bytes];
+    uint64_t length = [mappedData length];
+    
+    LFNetworkArchiveHeader header;
+    if (length < sizeof(header)) {
+        if (error) *error = LFNetworkArchiveCorruptError(path);
+        return nil;
+    }
+    memcpy(&header, bytes, sizeof(header));
+    
+    uint32_t count = NSSwapLittleIntToHost(header.count);
+    uint64_t indexOffset = NSSwapLittleLongLongToHost(header.indexOffset);
+    
+    if (memcmp(header.magic, LFNetworkArchiveMagic, sizeof(header.magic)) != 0 ||
+        NSSwapLittleIntToHost(header.version) != LFNetworkArchiveVersion ||
+        indexOffset > length ||
+        (length - indexOffset) / sizeof(LFNetworkArchiveIndexEntry) < count) {
+        if (error) *error = LFNetworkArchiveCorruptError(path);
+        return nil;
+    }
+    
+    NSMutableDictionary *entries = [NSMutableDictionary dictionary];
+    
+    for (uint32_t i = 0; i < count; i++) {
+        
+        LFNetworkArchiveIndexEntry indexEntry;
+        memcpy(&indexEntry, bytes + indexOffset + i * sizeof(indexEntry), sizeof(indexEntry));
+        
+        uint64_t keyOffset = NSSwapLittleLongLongToHost(indexEntry.keyOffset);
+        uint64_t keyLength = NSSwapLittleIntToHost(indexEntry.keyLength);
+        uint64_t headersOffset = NSSwapLittleLongLongToHost(indexEntry.headersOffset);
+        uint64_t headersLength = NSSwapLittleIntToHost(indexEntry.headersLength);
+        uint64_t bodyOffset = NSSwapLittleLongLongToHost(indexEntry.bodyOffset);
+        uint64_t bodyLength = NSSwapLittleLongLongToHost(indexEntry.bodyLength);
+        
+        if (keyOffset > indexOffset || keyLength > indexOffset - keyOffset ||
+            headersOffset > indexOffset || headersLength > indexOffset - headersOffset ||
+            bodyOffset > indexOffset || bodyLength > indexOffset - bodyOffset) {
+            if (error) *error = LFNetworkArchiveCorruptError(path);
+            return nil;
+        }
+        
+        NSString *key = [[NSString alloc] initWithBytes:bytes + keyOffset length:(NSUInteger)keyLength encoding:NSUTF8StringEncoding];
+        NSData *headersData = [NSData dataWithBytesNoCopy:(void *)(bytes + headersOffset) length:(NSUInteger)headersLength freeWhenDone:NO];
+        NSDictionary *headerFields = headersLength ? [NSJSONSerialization JSONObjectWithData:headersData options:0 error:NULL] : @{};
+        
+        if (!key || ![headerFields isKindOfClass:[NSDictionary class]] || !LFNetworkArchiveHeaderFieldsAreValid(headerFields)) {
+            if (error) *error = LFNetworkArchiveCorruptError(path);
+            return nil;
+        }
+        
+        LFNetworkArchiveEntry *entry = [[LFNetworkArchiveEntry alloc] init];
+        entry.statusCode = NSSwapLittleIntToHost(indexEntry.statusCode);
+        entry.headerFields = headerFields;
+        entry.bodyRange = NSMakeRange((NSUInteger)bodyOffset, (NSUInteger)bodyLength);
+        
+        NSMutableArray *keyEntries = entries[key];
+        if (!keyEntries) {
+            keyEntries = [NSMutableArray array];
+            entries[key] = keyEntries;
+        }
+        [keyEntries addObject:entry];
+    }
+    
+    self.mappedData = mappedData;
+    self.entries = entries;
+    self.cursors = [NSMutableDictionary dictionary];
+    _count = count;
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Lookup
+
++ (NSString *)keyForRequest:(NSURLRequest *)request {
+    return [NSString stringWithFormat:@"%@ %@", request.HTTPMethod ?: @"GET", [request.URL absoluteString]];
+}
+
+- (BOOL)containsResponseForRequest:(NSURLRequest *)request {
+    return nil != self.entries[[[self class] keyForRequest:request]];
+}
+
+- (NSHTTPURLResponse *)responseForRequest:(NSURLRequest *)request data:(NSData **)data {
+    
+    NSString *key = [[self class] keyForRequest:request];
+    NSArray *keyEntries = self.entries[key];
+    if (!keyEntries) {
+        return nil;
+    }
+    
+    NSUInteger cursor = 0;
+    @synchronized(self.cursors) {
+        cursor = [self.cursors[key] unsignedIntegerValue];
+        self.cursors[key] = @(cursor + 1);
+    }
+    
+    LFNetworkArchiveEntry *entry = keyEntries[cursor % [keyEntries count]];
+    
+    if (data) {
+        // Slice the mapping without copying; the deallocator keeps the mapping alive for as long as the slice is.
+        NSData *mappedData = self.mappedData;
+        *data = [[NSData alloc] initWithBytesNoCopy:(void *)((const uint8_t *)[mappedData bytes] + entry.bodyRange.location)
+                                             length:entry.bodyRange.length
+                                        deallocator:^(void *bytes, NSUInteger length) {
+                                            (void)mappedData;
+                                        }];
+    }
+    
+    return [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:entry.statusCode HTTPVersion:@"HTTP/1.1" headerFields:entry.headerFields];
+}
+
+@end
+
+#pragma mark -
+
+@interface LFNetworkArchiveWriter () {
+    FILE *_file;
+}
+
+@property (nonatomic, strong) NSString *path;
+@property (nonatomic, strong) NSMutableData *index;
+@property (nonatomic, assign) uint64_t offset;
+
+/** Response data buffered per in-flight task, keyed by task identifier. */
+@property (nonatomic, strong) NSMutableDictionary *pendingData;
+
+- (BOOL)writeData:(NSData *)data offset:(uint64_t *)offset error:(NSError **)error;
+
+@end
+
+@implementation LFNetworkArchiveWriter
+
+#pragma mark -
+#pragma mark Initialization
+
+- (instancetype)initWithPath:(NSString *)path error:(NSError **)error {
+    
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    
+    _file = fopen([path fileSystemRepresentation], "wb");
+    if (!_file) {
+        if (error) *error = LFNetworkArchivePOSIXError(path);
+        return nil;
+    }
+    
+    // Reserve the header; it is filled in by -finish: once the index offset is known.
+    LFNetworkArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    if (fwrite(&header, sizeof(header), 1, _file) != 1) {
+        if (error) *error = LFNetworkArchivePOSIXError(path);
+        fclose(_file);
+        return nil;
+    }
+    
+    self.path = path;
+    self.index = [NSMutableData data];
+    self.offset = sizeof(header);
+    self.pendingData = [NSMutableDictionary dictionary];
+    
+    return self;
+}
+
+- (void)dealloc {
+    if (_file) {
+        fclose(_file);
+    }
+}
+
+#pragma mark -
+#pragma mark Writing
+
+- (BOOL)writeData:(NSData *)data offset:(uint64_t *)offset error:(NSError **)error {
+    
+    *offset = self.offset;
+    
+    if ([data length] && fwrite([data bytes], [data length], 1, _file) != 1) {
+        if (error) *error = LFNetworkArchivePOSIXError(self.path);
+        return NO;
+    }
+    
+    self.offset += [data length];
+    
+    return YES;
+}
+
+- (BOOL)appendResponse:(NSHTTPURLResponse *)response data:(NSData *)data forRequest:(NSURLRequest *)request error:(NSError **)error {
+    
+    NSParameterAssert(response);
+    NSParameterAssert(request);
+    
+    NSMutableDictionary *headerFields = [[response allHeaderFields] mutableCopy] ?: [NSMutableDictionary dictionary];
+    [headerFields removeObjectForKey:@"Content-Encoding"];
+    headerFields[@"Content-Length"] = [NSString stringWithFormat:@"%lu", (unsigned long)[data length]];
+    
+    NSData *keyData = [[LFNetworkArchive keyForRequest:request] dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *headersData = [NSJSONSerialization dataWithJSONObject:headerFields options:0 error:error];
+    if (!headersData) {
+        return NO;
+    }
+    
+    @synchronized(self) {
+        
+        if (!_file) {
+            if (error) *error = [NSError errorWithDomain:LFNetworkArchiveErrorDomain code:LFNetworkArchiveErrorFinished userInfo:nil];
+            return NO;
+        }
+        
+        uint64_t keyOffset, headersOffset, bodyOffset;
+        
+        if (![self writeData:keyData offset:&keyOffset error:error] ||
+            ![self writeData:headersData offset:&headersOffset error:error] ||
+            ![self writeData:data offset:&bodyOffset error:error]) {
+            return NO;
+        }
+        
+        LFNetworkArchiveIndexEntry indexEntry;
+        memset(&indexEntry, 0, sizeof(indexEntry));
+        indexEntry.keyOffset = NSSwapHostLongLongToLittle(keyOffset);
+        indexEntry.keyLength = NSSwapHostIntToLittle((uint32_t)[keyData length]);
+        indexEntry.statusCode = NSSwapHostIntToLittle((uint32_t)[response statusCode]);
+        indexEntry.headersOffset = NSSwapHostLongLongToLittle(headersOffset);
+        indexEntry.headersLength = NSSwapHostIntToLittle((uint32_t)[headersData length]);
+        indexEntry.bodyOffset = NSSwapHostLongLongToLittle(bodyOffset);
+        indexEntry.bodyLength = NSSwapHostLongLongToLittle((uint64_t)[data length]);
+        
+        [self.index appendBytes:&indexEntry length:sizeof(indexEntry)];
+        _count++;
+    }
+    
+    return YES;
+}
+
+- (BOOL)finish:(NSError **)error {
+    
+    @synchronized(self) {
+        
+        if (!_file) {
+            if (error) *error = [NSError errorWithDomain:LFNetworkArchiveErrorDomain code:LFNetworkArchiveErrorFinished userInfo:nil];
+            return NO;
+        }
+        
+        [self.pendingData removeAllObjects];
+        
+        uint64_t indexOffset;
+        if (![self writeData:self.index offset:&indexOffset error:error]) {
+            return NO;
+        }
+        
+        LFNetworkArchiveHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LFNetworkArchiveMagic, sizeof(header.magic));
+        header.version = NSSwapHostIntToLittle(LFNetworkArchiveVersion);
+        header.count = NSSwapHostIntToLittle((uint32_t)_count);
+        header.indexOffset = NSSwapHostLongLongToLittle(indexOffset);
+        
+        BOOL success = (0 == fseek(_file, 0, SEEK_SET) && 1 == fwrite(&header, sizeof(header), 1, _file));
+        success = (0 == fclose(_file)) && success;
+        _file = NULL;
+        
+        if (!success && error) {
+            *error = LFNetworkArchivePOSIXError(self.path);
+        }
+        
+        return success;
+    }
+}
+
+#pragma mark -
+#pragma mark Capturing session tasks
+
+- (void)task:(NSURLSessionTask *)task didReceiveData:(NSData *)data {
+    @synchronized(self) {
+        NSMutableData *taskData = self.pendingData[@(task.taskIdentifier)];
+        if (taskData) {
+            [taskData appendData:data];
+        } else {
+            self.pendingData[@(task.taskIdentifier)] = [data mutableCopy];
+        }
+    }
+}
+
+- (void)task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    
+    NSData *data = nil;
+    
+    @synchronized(self) {
+        data = self.pendingData[@(task.taskIdentifier)];
+        [self.pendingData removeObjectForKey:@(task.taskIdentifier)];
+    }
+    
+    if (error || ![task.response isKindOfClass:[NSHTTPURLResponse class]] || !task.originalRequest) {
+        return;
+    }
+    
+    [self appendResponse:(NSHTTPURLResponse *)task.response data:data ?: [NSData data] forRequest:task.originalRequest error:NULL];
+}
+
+@end
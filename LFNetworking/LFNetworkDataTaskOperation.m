@@ -24,6 +24,7 @@
 // THE SOFTWARE.
 
 #import "LFNetworkDataTaskOperation.h"
+#import "LFNetworkTracer.h"
 
 @interface LFNetworkDataTaskOperation ()
 
@@ -56,12 +57,27 @@
 #pragma mark NSURLSessionTaskDelegate
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    
+    // An operation that was cancelled or shed before it started never began its task span.
+    if ([self isExecuting]) {
+        [self.tracer endSpan:LFNetworkTraceTask identifier:self.traceIdentifier];
+    }
+    
     if (self.didCompleteWithDataErrorHandler) {
-        dispatch_sync(self.completionQueue ?: dispatch_get_main_queue(), ^{
+        [self.tracer beginSpan:LFNetworkTraceDelivery identifier:self.traceIdentifier];
+        dispatch_block_t deliver = ^{
+            [self.tracer endSpan:LFNetworkTraceDelivery identifier:self.traceIdentifier];
             self.didCompleteWithDataErrorHandler(self, self.responseData, self.error ?: error);
             self.didCompleteWithDataErrorHandler = nil;
+            [self.tracer recordEvent:LFNetworkTraceDelivered identifier:self.traceIdentifier value:0];
 //            self.responseData = nil;
-        });
+        };
+        
+        if (self.completesOnDelegateQueue) {
+            deliver();
+        } else {
+            dispatch_sync(self.completionQueue ?: dispatch_get_main_queue(), deliver);
+        }
     }
     
     [self completeOperation];
@@ -72,6 +88,11 @@
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
     
+    if (self.tracer) {
+        NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? [(NSHTTPURLResponse *)response statusCode] : 0;
+        [self.tracer recordEvent:LFNetworkTraceResponse identifier:self.traceIdentifier value:statusCode];
+    }
+    
     if (self.didReceiveResponseHandler) {
         
         dispatch_sync(self.completionQueue ?: dispatch_get_main_queue(), ^{
@@ -108,6 +129,8 @@
     
     self.bytesReceived += [data length];
     
+    [self.tracer recordEvent:LFNetworkTraceData identifier:self.traceIdentifier value:(int64_t)[data length]];
+    
     if (self.didReceiveDataHandler) {
         dispatch_sync(self.completionQueue ?: dispatch_get_main_queue(), ^{
             self.didReceiveDataHandler(self, data, self.totalBytesExpected, self.bytesReceived);
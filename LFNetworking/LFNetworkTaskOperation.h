@@ -27,6 +27,15 @@
 
 @class LFNetworkTaskOperation;
 @class LFNetworkDataTaskOperation;
+@class LFNetworkTracer;
+
+/** The error domain of errors created by `LFNetworkTaskOperation`. */
+extern NSString * const LFNetworkTaskOperationErrorDomain;
+
+typedef NS_ENUM(NSInteger, LFNetworkTaskOperationError) {
+    /** The operation's `deadline` passed before it could finish. */
+    LFNetworkTaskOperationErrorDeadlineExceeded = 1,
+};
 
 typedef void(^LFURLSessionTaskDidCompleteWithDataErrorBlock)(LFNetworkTaskOperation *operation,
                                                 NSData *data,
@@ -132,6 +141,56 @@ typedef void(^LFURLSessionTaskWillPerformHTTPRedirectionBlock)(LFNetworkTaskOper
  */
 @property (nonatomic, strong) dispatch_queue_t completionQueue;
 
+/**
+ Whether `didCompleteWithDataErrorHandler` is invoked directly on the session's delegate queue instead of on `completionQueue`. Defaults to `NO`.
+ 
+ Set this when the handler only hands the result on to more background work (as `LFPromise` does), to save a round trip through `completionQueue`. The handler then must not block or touch the UI.
+ */
+@property (nonatomic, assign) BOOL completesOnDelegateQueue;
+
+///--------------
+/// @name Tracing
+///--------------
+
+/**
+ The tracer that records this operation's lifecycle. Set by `LFURLSessionManager` when it has a `tracer`; `nil` (default) disables tracing.
+ */
+@property (nonatomic, strong) LFNetworkTracer *tracer;
+
+/**
+ The identifier grouping this operation's events in the `tracer`.
+ */
+@property (nonatomic, assign) uint64_t traceIdentifier;
+
+///----------------
+/// @name Deadlines
+///----------------
+
+/**
+ The time after which the result of this operation is no longer useful. `nil` (default) means it never expires.
+ 
+ If the deadline has already passed when the queue starts the operation, the operation is shed: it finishes without ever resuming its task. If the deadline passes while the task is running, the task is cancelled. In both cases the completion handler receives an `LFNetworkTaskOperationErrorDeadlineExceeded` error.
+ 
+ When no deadline is set, the operation inherits one from the operations that depend on it (see `addDependency:`): the latest of their deadlines, or none if any of them has none. Cancelled dependents are ignored, except that once every dependent is cancelled and at least one of them had a deadline, the inherited deadline is `distantPast` and the operation is shed. Inheritance is transitive, so a deadline on the last operation of a chain bounds the whole chain.
+ 
+ @note The deadline is evaluated when the operation starts; changing it afterwards does not move the running task's cut-off.
+ */
+@property (nonatomic, strong) NSDate *deadline;
+
+/**
+ Whether the operation was shed or cancelled because its `deadline` passed.
+ */
+@property (atomic, readonly, getter = isDeadlineExceeded) BOOL deadlineExceeded;
+
+/** The number of operations, across all instances, shed before their task was resumed. */
++ (NSUInteger)numberOfOperationsShedBeforeStart;
+
+/** The number of operations, across all instances, whose running task was cancelled at its deadline. */
++ (NSUInteger)numberOfOperationsCancelledAtDeadline;
+
+/** Reset the deadline counters to zero. */
++ (void)resetDeadlineCounters;
+
 /// --------------------
 /// @name Initialization
 /// --------------------
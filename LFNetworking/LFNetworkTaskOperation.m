@@ -24,11 +24,23 @@
 // THE SOFTWARE.
 
 #import "LFNetworkTaskOperation.h"
+#import "LFNetworkTracer.h"
+
+#import <stdatomic.h>
+
+NSString * const LFNetworkTaskOperationErrorDomain = @"LFNetworkTaskOperationErrorDomain";
+
+static atomic_uint_fast64_t LFNetworkTaskOperationShedCount = 0;
+static atomic_uint_fast64_t LFNetworkTaskOperationExpiredCount = 0;
 
 @interface LFNetworkTaskOperation ()
 
 @property (nonatomic, readwrite, getter = isFinished) BOOL finished;
 @property (nonatomic, readwrite, getter = isExecuting) BOOL executing;
+@property (atomic, readwrite, getter = isDeadlineExceeded) BOOL deadlineExceeded;
+
+/** Operations that have added this one as a dependency, used for deadline inheritance. */
+@property (nonatomic, strong) NSHashTable *dependents;
 
 @end
 
@@ -36,6 +48,7 @@
 
 @synthesize executing = _executing;
 @synthesize finished = _finished;
+@synthesize deadline = _deadline;
 
 #pragma mark -
 #pragma mark Initialization
@@ -59,12 +72,49 @@
 
     // "For operations that are queued but not yet executing, the queue must still call the operation object’s start method so that it can processes the cancellation event and mark itself as finished." So we must do the checking here in case it has already been canceled.
     if ([self isCancelled]) {
+        [self.tracer endSpan:LFNetworkTraceQueued identifier:self.traceIdentifier];
+        [self.tracer recordEvent:LFNetworkTraceCancelled identifier:self.traceIdentifier value:0];
+        self.finished = YES;
+        return;
+    }
+    
+    [self.tracer endSpan:LFNetworkTraceQueued identifier:self.traceIdentifier];
+    
+    // Shed the operation if nobody is waiting for its result anymore. Cancelling the suspended task still makes the session
+    // report completion, which is where the completion handler is told about the deadline.
+    NSDate *deadline = self.deadline;
+    NSTimeInterval remaining = deadline ? [deadline timeIntervalSinceNow] : 0;
+    if (deadline && remaining <= 0) {
+        atomic_fetch_add(&LFNetworkTaskOperationShedCount, 1);
+        [self.tracer recordEvent:LFNetworkTraceDeadlineExceeded identifier:self.traceIdentifier value:0];
+        self.deadlineExceeded = YES;
+        [self cancel];
         self.finished = YES;
         return;
     }
     
+    [self.tracer recordEvent:LFNetworkTraceStarted identifier:self.traceIdentifier value:0];
+    [self.tracer beginSpan:LFNetworkTraceTask identifier:self.traceIdentifier];
+    
     self.executing = YES;
     [self.task resume];
+    
+    // A deadline too far off to express in nanoseconds (e.g. `distantFuture`) never fires, so don't arm a timer for it;
+    // converting it to int64_t would be undefined.
+    if (deadline && remaining < (double)INT64_MAX / NSEC_PER_SEC) {
+        __weak LFNetworkTaskOperation *weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(remaining * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            LFNetworkTaskOperation *strongSelf = weakSelf;
+            // The last byte may already be in while the session has yet to report completion; leave that task alone.
+            if (!strongSelf || ![strongSelf isExecuting] || [strongSelf isCancelled] || NSURLSessionTaskStateRunning != strongSelf.task.state) {
+                return;
+            }
+            atomic_fetch_add(&LFNetworkTaskOperationExpiredCount, 1);
+            [strongSelf.tracer recordEvent:LFNetworkTraceDeadlineExceeded identifier:strongSelf.traceIdentifier value:1];
+            strongSelf.deadlineExceeded = YES;
+            [strongSelf cancel];
+        });
+    }
 }
 
 - (void)cancel {
@@ -77,9 +127,96 @@
     self.finished = YES;
 }
 
+#pragma mark -
+#pragma mark Deadlines
+
+- (void)setDeadline:(NSDate *)deadline {
+    @synchronized(self) {
+        _deadline = deadline;
+    }
+}
+
+- (NSDate *)deadline {
+    
+    NSArray *dependents = nil;
+    
+    @synchronized(self) {
+        if (_deadline) {
+            return _deadline;
+        }
+        dependents = [self.dependents allObjects];
+    }
+    
+    NSDate *inheritedDeadline = nil;
+    
+    BOOL hasLiveDependent = NO;
+    BOOL hasCancelledDependentWithDeadline = NO;
+    
+    for (LFNetworkTaskOperation *dependent in dependents) {
+        NSDate *dependentDeadline = dependent.deadline;
+        
+        if ([dependent isCancelled]) {
+            hasCancelledDependentWithDeadline = hasCancelledDependentWithDeadline || nil != dependentDeadline;
+            continue;
+        }
+        
+        if (!dependentDeadline) {
+            return nil;
+        }
+        
+        hasLiveDependent = YES;
+        inheritedDeadline = inheritedDeadline ? [inheritedDeadline laterDate:dependentDeadline] : dependentDeadline;
+    }
+    
+    // Everything in a deadline-bound chain that was waiting for this result is gone, so it is already too late.
+    if (!hasLiveDependent && hasCancelledDependentWithDeadline) {
+        return [NSDate distantPast];
+    }
+    
+    return inheritedDeadline;
+}
+
++ (NSUInteger)numberOfOperationsShedBeforeStart {
+    return (NSUInteger)atomic_load(&LFNetworkTaskOperationShedCount);
+}
+
++ (NSUInteger)numberOfOperationsCancelledAtDeadline {
+    return (NSUInteger)atomic_load(&LFNetworkTaskOperationExpiredCount);
+}
+
++ (void)resetDeadlineCounters {
+    atomic_store(&LFNetworkTaskOperationShedCount, 0);
+    atomic_store(&LFNetworkTaskOperationExpiredCount, 0);
+}
+
 #pragma mark -
 #pragma mark NSOperation methods;
 
+- (void)addDependency:(NSOperation *)operation {
+    [super addDependency:operation];
+    
+    if ([operation isKindOfClass:[LFNetworkTaskOperation class]]) {
+        LFNetworkTaskOperation *taskOperation = (LFNetworkTaskOperation *)operation;
+        @synchronized(taskOperation) {
+            if (!taskOperation.dependents) {
+                taskOperation.dependents = [NSHashTable weakObjectsHashTable];
+            }
+            [taskOperation.dependents addObject:self];
+        }
+    }
+}
+
+- (void)removeDependency:(NSOperation *)operation {
+    if ([operation isKindOfClass:[LFNetworkTaskOperation class]]) {
+        LFNetworkTaskOperation *taskOperation = (LFNetworkTaskOperation *)operation;
+        @synchronized(taskOperation) {
+            [taskOperation.dependents removeObject:self];
+        }
+    }
+    
+    [super removeDependency:operation];
+}
+
 - (BOOL)isConcurrent {
     return YES;
 }
@@ -109,11 +246,25 @@
     
     // Warning: Subclass should override this method.
     
+    // An operation that was cancelled or shed before it started never began its task span.
+    if ([self isExecuting]) {
+        [self.tracer endSpan:LFNetworkTraceTask identifier:self.traceIdentifier];
+    }
+    
     if (self.didCompleteWithDataErrorHandler) {
-        dispatch_sync(self.completionQueue ?: dispatch_get_main_queue(), ^{
+        [self.tracer beginSpan:LFNetworkTraceDelivery identifier:self.traceIdentifier];
+        dispatch_block_t deliver = ^{
+            [self.tracer endSpan:LFNetworkTraceDelivery identifier:self.traceIdentifier];
             self.didCompleteWithDataErrorHandler(self, nil, error);
             self.didCompleteWithDataErrorHandler = nil;
-        });
+            [self.tracer recordEvent:LFNetworkTraceDelivered identifier:self.traceIdentifier value:0];
+        };
+        
+        if (self.completesOnDelegateQueue) {
+            deliver();
+        } else {
+            dispatch_sync(self.completionQueue ?: dispatch_get_main_queue(), deliver);
+        }
     }
 
     [self completeOperation];
@@ -0,0 +1,85 @@
+//
+//  LFNetworkTaskRecord.h
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+#import "LFURLSessionManager.h"
+
+/** The bookkeeping for one task started with `-[LFURLSessionManager directDataTaskWithRequest:completionHandler:]`.
+ *
+ * Unlike `<LFNetworkDataTaskOperation>`, a record is a plain object: it has no KVO-observed state, carries a
+ * single completion handler and is recycled by the manager once the task completes. Records are owned by the
+ * manager and never handed out, since a recycled record may already belong to another task.
+ */
+
+@interface LFNetworkTaskRecord : NSObject
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/// The task this record tracks.
+
+@property (nonatomic, strong) NSURLSessionTask *task;
+
+/// The block called with the outcome of the task.
+
+@property (nonatomic, copy) LFURLSessionTaskDidCompleteBlock completionHandler;
+
+/// The response received so far, if any.
+
+@property (nonatomic, strong) NSURLResponse *response;
+
+/// The body received so far, if any.
+
+@property (nonatomic, readonly) NSData *data;
+
+/// Whether the task is waiting for one of the manager's direct task slots. A caller may have resumed it anyway.
+
+@property (nonatomic, assign, getter = isPending) BOOL pending;
+
+/// The tracer to record into, or `nil`.
+
+@property (nonatomic, strong) LFNetworkTracer *tracer;
+
+/// The identifier of the task's track in `tracer`.
+
+@property (nonatomic, assign) uint64_t traceIdentifier;
+
+/// ----------------
+/// @name Lifecycle
+/// ----------------
+
+/** Append a chunk of the body.
+ *
+ * The first chunk is kept as is; only a body that arrives in several chunks is copied into a buffer.
+ *
+ * @param data The chunk received by the session.
+ */
+- (void)appendData:(NSData *)data;
+
+/** Drop every reference the record holds so that it can be used for another task. */
+- (void)prepareForReuse;
+
+@end
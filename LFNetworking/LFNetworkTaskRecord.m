@@ -0,0 +1,67 @@
+//
+//  LFNetworkTaskRecord.m
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "LFNetworkTaskRecord.h"
+
+@interface LFNetworkTaskRecord ()
+
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSMutableData *mutableData;
+
+@end
+
+@implementation LFNetworkTaskRecord
+
+#pragma mark -
+#pragma mark Lifecycle
+
+- (void)appendData:(NSData *)data {
+    
+    if (!self.data) {
+        self.data = data;
+        return;
+    }
+    
+    if (!self.mutableData) {
+        self.mutableData = [NSMutableData dataWithCapacity:[self.data length] + [data length]];
+        [self.mutableData appendData:self.data];
+        self.data = self.mutableData;
+    }
+    
+    [self.mutableData appendData:data];
+}
+
+- (void)prepareForReuse {
+    self.task = nil;
+    self.completionHandler = nil;
+    self.response = nil;
+    self.data = nil;
+    self.mutableData = nil;
+    self.pending = NO;
+    self.tracer = nil;
+    self.traceIdentifier = 0;
+}
+
+@end
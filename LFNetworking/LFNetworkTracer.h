@@ -0,0 +1,134 @@
+//
+//  LFNetworkTracer.h
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+/** Span and event names recorded by `LFURLSessionManager` and its operations. */
+extern const char * const LFNetworkTraceQueued;
+extern const char * const LFNetworkTraceTask;
+extern const char * const LFNetworkTraceSerialization;
+extern const char * const LFNetworkTraceDelivery;
+extern const char * const LFNetworkTraceEnqueued;
+extern const char * const LFNetworkTraceStarted;
+extern const char * const LFNetworkTraceCancelled;
+extern const char * const LFNetworkTraceResponse;
+extern const char * const LFNetworkTraceData;
+extern const char * const LFNetworkTraceSerialized;
+extern const char * const LFNetworkTraceDelivered;
+extern const char * const LFNetworkTraceDeadlineExceeded;
+
+/** Records operation lifecycles into a fixed-size, lock-free ring buffer.
+ *
+ * Assign an instance to `<LFURLSessionManager>`'s `tracer` property to have every operation created by
+ * that manager record its queue wait, task and delivery spans, plus instant events for the response and
+ * each data chunk. Events are timestamped and tagged with the recording thread, and can be exported as
+ * Chrome trace-event JSON, which both `chrome://tracing` and Perfetto load directly.
+ *
+ * Recording never takes a lock or allocates: each event claims a slot with an atomic increment and takes it over
+ * with a compare-and-swap. When the buffer wraps, the oldest events are overwritten. In the rare case that a writer
+ * finds its slot still being filled by another one a whole buffer apart, it drops its event rather than wait.
+ *
+ * @note Event names are stored by pointer and must be string literals or otherwise outlive the tracer.
+ */
+
+@interface LFNetworkTracer : NSObject
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/** Whether events are recorded. Defaults to `YES`.
+
+ Leaving the tracer attached but disabled costs one message send and a flag check per event.
+ */
+@property (atomic, assign, getter = isEnabled) BOOL enabled;
+
+/** The number of events the ring buffer holds before it starts overwriting the oldest ones. */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/// --------------------
+/// @name Initialization
+/// --------------------
+
+/** Create a tracer with a buffer of 65536 events. */
+- (instancetype)init;
+
+/** Create a tracer.
+ *
+ * @param capacity The number of events to keep. It is rounded up to the next power of two.
+ *
+ * @return Returns `LFNetworkTracer`.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/// ----------------------
+/// @name Recording events
+/// ----------------------
+
+/** Return a new identifier used to group the events of one operation onto its own track. */
+- (uint64_t)nextIdentifier;
+
+/** Record the beginning of an asynchronous span.
+ *
+ * @param name The span name.
+ * @param identifier The identifier of the operation the span belongs to.
+ */
+- (void)beginSpan:(const char *)name identifier:(uint64_t)identifier;
+
+/** Record the end of an asynchronous span previously started with `beginSpan:identifier:`.
+ *
+ * @param name The span name.
+ * @param identifier The identifier of the operation the span belongs to.
+ */
+- (void)endSpan:(const char *)name identifier:(uint64_t)identifier;
+
+/** Record an instant event.
+ *
+ * @param name The event name.
+ * @param identifier The identifier of the operation the event belongs to.
+ * @param value An event-specific value (e.g. status code or chunk length), exported as `args.value`.
+ */
+- (void)recordEvent:(const char *)name identifier:(uint64_t)identifier value:(int64_t)value;
+
+/** Discard all recorded events. */
+- (void)reset;
+
+/// ---------------
+/// @name Exporting
+/// ---------------
+
+/** Return the recorded events as Chrome trace-event JSON (the `{"traceEvents": [...]}` object format). */
+- (NSData *)traceEventData;
+
+/** Write the recorded events as Chrome trace-event JSON.
+ *
+ * @param path The file to write.
+ * @param error On failure, the reason.
+ *
+ * @return `YES` if the file was written.
+ */
+- (BOOL)writeTraceEventsToFile:(NSString *)path error:(NSError **)error;
+
+@end
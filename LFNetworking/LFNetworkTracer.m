@@ -0,0 +1,273 @@
+//
+//  LFNetworkTracer.m
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "LFNetworkTracer.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+#import <unistd.h>
+
+#if defined(__APPLE__)
+#import <mach/mach_time.h>
+#else
+#import <time.h>
+#import <sys/syscall.h>
+#endif
+
+const char * const LFNetworkTraceQueued = "queued";
+const char * const LFNetworkTraceTask = "task";
+const char * const LFNetworkTraceSerialization = "serialization";
+const char * const LFNetworkTraceDelivery = "delivery";
+const char * const LFNetworkTraceEnqueued = "enqueued";
+const char * const LFNetworkTraceStarted = "started";
+const char * const LFNetworkTraceCancelled = "cancelled";
+const char * const LFNetworkTraceResponse = "response";
+const char * const LFNetworkTraceData = "data";
+const char * const LFNetworkTraceSerialized = "serialized";
+const char * const LFNetworkTraceDelivered = "delivered";
+const char * const LFNetworkTraceDeadlineExceeded = "deadline exceeded";
+
+static NSUInteger const LFNetworkTracerDefaultCapacity = 1 << 16;
+
+// Monotonic time in nanoseconds. CLOCK_MONOTONIC only arrived in iOS 10 and OS X 10.12, so Apple platforms use mach time.
+static uint64_t LFNetworkTraceTimestamp(void) {
+#if defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// The ID tools show for the current thread: the Mach port on Apple platforms, the kernel thread ID on Linux.
+static uint64_t LFNetworkTraceThreadID(void) {
+#if defined(__APPLE__)
+    return pthread_mach_thread_np(pthread_self());
+#elif defined(__linux__)
+    return (uint64_t)syscall(SYS_gettid);
+#else
+    return (uint64_t)(uintptr_t)pthread_self();
+#endif
+}
+
+// Each slot is guarded by its own sequence word, seqlock style. For the event at index i, the word is
+// (i + 1) << 1 once published and ((i + 1) << 1) | 1 while being written. A writer takes the slot by
+// compare-and-swap from an older published (or empty) state to its own writing state, so two writers that
+// lapped each other never fill the same slot at once: whoever finds the slot busy or already newer drops its
+// event. A reader only keeps a slot whose word was the published state for the index it wants, unchanged
+// on both sides of the copy. Payload fields are relaxed atomics so that concurrent copies are not data races.
+typedef struct {
+    _Atomic uint64_t sequence;
+    _Atomic(const char *) name;
+    _Atomic uint64_t identifier;
+    _Atomic uint64_t timestamp;
+    _Atomic uint64_t threadID;
+    _Atomic int64_t value;
+    _Atomic char phase;
+} LFNetworkTraceEvent;
+
+typedef struct {
+    const char *name;
+    uint64_t identifier;
+    uint64_t timestamp;
+    uint64_t threadID;
+    int64_t value;
+    char phase;
+} LFNetworkTraceEventCopy;
+
+static inline uint64_t LFNetworkTracePublishedSequence(uint64_t index) {
+    return (index + 1) << 1;
+}
+
+@interface LFNetworkTracer () {
+    LFNetworkTraceEvent *_events;
+    NSUInteger _mask;
+    _Atomic uint64_t _head;
+    _Atomic uint64_t _floor;
+    _Atomic uint64_t _identifier;
+    uint64_t _startTime;
+}
+
+@end
+
+@implementation LFNetworkTracer
+
+#pragma mark -
+#pragma mark Initialization
+
+- (instancetype)init {
+    return [self initWithCapacity:LFNetworkTracerDefaultCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    NSUInteger roundedCapacity = 1;
+    while (roundedCapacity < MAX(capacity, (NSUInteger)2)) {
+        roundedCapacity <<= 1;
+    }
+
+    _capacity = roundedCapacity;
+    _mask = roundedCapacity - 1;
+    _events = calloc(roundedCapacity, sizeof(LFNetworkTraceEvent));
+    if (!_events) {
+        return nil;
+    }
+
+    atomic_init(&_head, 0);
+    atomic_init(&_floor, 0);
+    atomic_init(&_identifier, 0);
+    _startTime = LFNetworkTraceTimestamp();
+    _enabled = YES;
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_events);
+}
+
+#pragma mark -
+#pragma mark Recording
+
+- (uint64_t)nextIdentifier {
+    return atomic_fetch_add_explicit(&_identifier, 1, memory_order_relaxed) + 1;
+}
+
+- (void)beginSpan:(const char *)name identifier:(uint64_t)identifier {
+    [self recordPhase:'b' name:name identifier:identifier value:0];
+}
+
+- (void)endSpan:(const char *)name identifier:(uint64_t)identifier {
+    [self recordPhase:'e' name:name identifier:identifier value:0];
+}
+
+- (void)recordEvent:(const char *)name identifier:(uint64_t)identifier value:(int64_t)value {
+    [self recordPhase:'n' name:name identifier:identifier value:value];
+}
+
+- (void)recordPhase:(char)phase name:(const char *)name identifier:(uint64_t)identifier value:(int64_t)value {
+
+    if (!self.enabled || !identifier) {
+        return;
+    }
+
+    uint64_t index = atomic_fetch_add_explicit(&_head, 1, memory_order_relaxed);
+    LFNetworkTraceEvent *event = &_events[index & _mask];
+    uint64_t published = LFNetworkTracePublishedSequence(index);
+
+    uint64_t sequence = atomic_load_explicit(&event->sequence, memory_order_relaxed);
+    do {
+        // Another writer is filling this slot, or one that lapped us already has; rather than wait, lose the event.
+        if ((sequence & 1) || sequence >= published) {
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&event->sequence, &sequence, published | 1, memory_order_relaxed, memory_order_relaxed));
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&event->name, name, memory_order_relaxed);
+    atomic_store_explicit(&event->identifier, identifier, memory_order_relaxed);
+    atomic_store_explicit(&event->timestamp, LFNetworkTraceTimestamp(), memory_order_relaxed);
+    atomic_store_explicit(&event->threadID, LFNetworkTraceThreadID(), memory_order_relaxed);
+    atomic_store_explicit(&event->value, value, memory_order_relaxed);
+    atomic_store_explicit(&event->phase, phase, memory_order_relaxed);
+
+    atomic_store_explicit(&event->sequence, published, memory_order_release);
+}
+
+- (void)reset {
+    // Writers never stop, so rather than clearing slots just move the export window past them.
+    atomic_store_explicit(&_floor, atomic_load_explicit(&_head, memory_order_acquire), memory_order_release);
+}
+
+#pragma mark -
+#pragma mark Exporting
+
+- (NSData *)traceEventData {
+
+    uint64_t head = atomic_load_explicit(&_head, memory_order_acquire);
+    uint64_t first = MAX(head > _capacity ? head - _capacity : 0, atomic_load_explicit(&_floor, memory_order_acquire));
+
+    NSNumber *processID = @(getpid());
+    NSMutableArray *traceEvents = [NSMutableArray arrayWithCapacity:(NSUInteger)(head - first)];
+
+    for (uint64_t index = first; index < head; index++) {
+
+        LFNetworkTraceEvent *slot = &_events[index & _mask];
+
+        // Skip slots that were never written, are being written, or hold an older or newer event.
+        uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence != LFNetworkTracePublishedSequence(index)) {
+            continue;
+        }
+
+        LFNetworkTraceEventCopy event;
+        event.name = atomic_load_explicit(&slot->name, memory_order_relaxed);
+        event.identifier = atomic_load_explicit(&slot->identifier, memory_order_relaxed);
+        event.timestamp = atomic_load_explicit(&slot->timestamp, memory_order_relaxed);
+        event.threadID = atomic_load_explicit(&slot->threadID, memory_order_relaxed);
+        event.value = atomic_load_explicit(&slot->value, memory_order_relaxed);
+        event.phase = atomic_load_explicit(&slot->phase, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+
+        // Skip slots that were overwritten while we copied them.
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        double microseconds = event.timestamp > _startTime ? (double)(event.timestamp - _startTime) / 1000.0 : 0.0;
+
+        NSMutableDictionary *traceEvent = [@{@"name": @(event.name),
+                                             @"cat": @"LFNetworking",
+                                             @"ph": [NSString stringWithFormat:@"%c", event.phase],
+                                             @"ts": @(microseconds),
+                                             @"pid": processID,
+                                             @"tid": @(event.threadID),
+                                             @"id": [NSString stringWithFormat:@"0x%llx", event.identifier]} mutableCopy];
+        if ('n' == event.phase) {
+            traceEvent[@"args"] = @{@"value": @(event.value)};
+        }
+
+        [traceEvents addObject:traceEvent];
+    }
+
+    return [NSJSONSerialization dataWithJSONObject:@{@"traceEvents": traceEvents, @"displayTimeUnit": @"ms"} options:0 error:NULL];
+}
+
+- (BOOL)writeTraceEventsToFile:(NSString *)path error:(NSError **)error {
+    return [[self traceEventData] writeToFile:path options:NSDataWritingAtomic error:error];
+}
+
+@end
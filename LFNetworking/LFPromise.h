@@ -0,0 +1,157 @@
+//
+//  LFPromise.h
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+/** The error domain of errors created by `LFPromise`. */
+extern NSString * const LFPromiseErrorDomain;
+
+typedef NS_ENUM(NSInteger, LFPromiseError) {
+    /** `any:` or `race:` was given no promises to wait for. */
+    LFPromiseErrorNoPromises = 1,
+};
+
+@class LFPromise;
+
+typedef id(^LFPromiseThenBlock)(id value);
+typedef id(^LFPromiseMapBlock)(id value);
+typedef id(^LFPromiseRecoverBlock)(NSError *error);
+typedef void(^LFPromiseDoneBlock)(id value, NSError *error);
+
+/** A value that will become available later, usually the result of a `<LFNetworkDataTaskOperation>`.
+ *
+ * Promises are created by `<LFURLSessionManager>` method `promiseWithRequest:` and `<LFHTTPSessionManager>` method
+ * `promiseWithHTTPMethod:URLString:parameters:`, and composed with `then:`, `map:`, `recover:`, `all:`, `any:` and `race:`.
+ *
+ * Continuations run synchronously on whatever thread settles the promise, which for network promises is the session's
+ * delegate queue. That way a request that depends on the result of another one is started without a trip through the
+ * main queue. Only the block passed to `done:` is dispatched to `completionQueue`, so keep continuations short and
+ * free of UI work.
+ *
+ * Cancelling a promise rejects it with `NSURLErrorCancelled` and cancels its underlying operations. The promises it
+ * was derived from are cancelled only once nothing else waits on them: with several chains hanging off one request,
+ * cancelling one chain leaves the shared request and the other chains running. A `done:` block counts as waiting for
+ * good.
+ */
+
+@interface LFPromise : NSObject
+
+/// ----------------
+/// @name Properties
+/// ----------------
+
+/** The GCD queue to which the `done:` block is dispatched. If `nil`, it will use `dispatch_get_main_queue()`.
+ *
+ * Promises derived from this one inherit it.
+ */
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+
+/** Whether the promise has been fulfilled or rejected. */
+@property (nonatomic, readonly, getter = isSettled) BOOL settled;
+
+/** The value the promise was fulfilled with, `nil` until then. */
+@property (nonatomic, readonly) id value;
+
+/** The error the promise was rejected with, `nil` until then. */
+@property (nonatomic, readonly) NSError *error;
+
+/// --------------------
+/// @name Initialization
+/// --------------------
+
+/** Create a pending promise, to be settled with `fulfill:` or `reject:`. */
+- (instancetype)init;
+
+/** Create a promise fulfilled with `value`. */
++ (instancetype)promiseWithValue:(id)value;
+
+/** Create a promise rejected with `error`. */
++ (instancetype)promiseWithError:(NSError *)error;
+
+/// ----------------
+/// @name Settlement
+/// ----------------
+
+/** Fulfill the promise. If `value` is itself an `LFPromise`, this one settles the same way once it does.
+ *
+ * Has no effect if the promise is already settled.
+ */
+- (void)fulfill:(id)value;
+
+/** Reject the promise. Has no effect if the promise is already settled. */
+- (void)reject:(NSError *)error;
+
+/** Add an operation to be cancelled when the promise is cancelled. It is released once the promise settles. */
+- (void)addCancellableOperation:(NSOperation *)operation;
+
+/** Reject the promise with `NSURLErrorCancelled`, cancel its operations and let go of the promises it waits on. */
+- (void)cancel;
+
+/// -----------------
+/// @name Composition
+/// -----------------
+
+/** Chain a continuation to run once the promise is fulfilled.
+ *
+ * @param block Called with the fulfilled value. It may return a value, an `NSError` to reject the returned promise,
+ *              or another `LFPromise` (e.g. the next request) to wait for.
+ *
+ * @return A promise for the result of `block`. If this promise is rejected, it is rejected with the same error and `block` is not called.
+ */
+- (LFPromise *)then:(LFPromiseThenBlock)block;
+
+/** Transform the fulfilled value. Unlike `then:`, whatever `block` returns becomes the value as is. */
+- (LFPromise *)map:(LFPromiseMapBlock)block;
+
+/** Handle a rejection.
+ *
+ * @param block Called with the error. It may return a replacement value, an `NSError`, or another `LFPromise`, as with `then:`.
+ *
+ * @return A promise fulfilled with this promise's value, or settled with the result of `block` if this promise is rejected.
+ */
+- (LFPromise *)recover:(LFPromiseRecoverBlock)block;
+
+/** Consume the result on `completionQueue`.
+ *
+ * @param block Called with the value, or with `nil` and the error.
+ */
+- (void)done:(LFPromiseDoneBlock)block;
+
+/** Return a promise fulfilled with an array of the values of `promises`, in order, once all are fulfilled.
+ *
+ * The first rejection rejects the returned promise and cancels the others that nothing else waits on. `NSNull` stands in for `nil` values.
+ */
++ (LFPromise *)all:(NSArray *)promises;
+
+/** Return a promise fulfilled with the first value among `promises`; the others are then cancelled, unless something else waits on them.
+ *
+ * If all of them are rejected, it is rejected with the last error.
+ */
++ (LFPromise *)any:(NSArray *)promises;
+
+/** Return a promise settled like the first of `promises` to settle; the others are then cancelled, unless something else waits on them. */
++ (LFPromise *)race:(NSArray *)promises;
+
+@end
@@ -0,0 +1,435 @@
+//
+//  LFPromise.m
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "LFPromise.h"
+
+#import <pthread.h>
+
+NSString * const LFPromiseErrorDomain = @"LFPromiseErrorDomain";
+
+typedef void(^LFPromiseSettleBlock)(LFPromise *promise);
+
+@interface LFPromise () {
+    pthread_mutex_t _lock;
+}
+
+@property (nonatomic, readwrite, getter = isSettled) BOOL settled;
+@property (nonatomic, readwrite, strong) id value;
+@property (nonatomic, readwrite, strong) NSError *error;
+
+/** Blocks waiting for the promise to settle. */
+@property (nonatomic, strong) NSMutableArray *callbacks;
+
+/** Operations cancelled along with this promise. */
+@property (nonatomic, strong) NSMutableArray *cancellables;
+
+/** Promises this one waits on. It is one of their consumers until it settles. */
+@property (nonatomic, strong) NSMutableArray *upstreamPromises;
+
+/** Promises waiting on this one, plus `done:` blocks. Once the last promise lets go before this one settles, it is cancelled. */
+@property (nonatomic, assign) NSUInteger consumerCount;
+
+- (void)settleWithValue:(id)value error:(NSError *)error;
+- (void)whenSettled:(LFPromiseSettleBlock)block;
+- (void)resolveWithResult:(id)result;
+- (void)addCancellable:(id)cancellable;
+- (void)waitOnPromise:(LFPromise *)promise;
+- (void)addConsumer;
+- (void)removeConsumer;
+- (LFPromise *)derivedPromise;
+
+@end
+
+@implementation LFPromise
+
+#pragma mark -
+#pragma mark Initialization
+
+- (instancetype)init {
+    
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    
+    pthread_mutex_init(&_lock, NULL);
+    
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
++ (instancetype)promiseWithValue:(id)value {
+    LFPromise *promise = [[self alloc] init];
+    [promise fulfill:value];
+    return promise;
+}
+
++ (instancetype)promiseWithError:(NSError *)error {
+    LFPromise *promise = [[self alloc] init];
+    [promise reject:error];
+    return promise;
+}
+
+- (LFPromise *)derivedPromise {
+    LFPromise *promise = [[LFPromise alloc] init];
+    promise.completionQueue = self.completionQueue;
+    [promise waitOnPromise:self];
+    return promise;
+}
+
+#pragma mark -
+#pragma mark Settlement
+
+- (void)fulfill:(id)value {
+    if ([value isKindOfClass:[LFPromise class]]) {
+        [self resolveWithResult:value];
+    } else {
+        [self settleWithValue:value error:nil];
+    }
+}
+
+- (void)reject:(NSError *)error {
+    NSParameterAssert(error);
+    [self settleWithValue:nil error:error];
+}
+
+- (void)settleWithValue:(id)value error:(NSError *)error {
+    
+    NSArray *callbacks = nil;
+    NSArray *upstreamPromises = nil;
+    
+    pthread_mutex_lock(&_lock);
+    if (self.settled) {
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    self.value = value;
+    self.error = error;
+    self.settled = YES;
+    callbacks = self.callbacks;
+    self.callbacks = nil;
+    self.cancellables = nil;
+    upstreamPromises = self.upstreamPromises;
+    self.upstreamPromises = nil;
+    pthread_mutex_unlock(&_lock);
+    
+    // Nothing upstream is needed anymore; whatever is still pending is cancelled unless another promise waits on it.
+    for (LFPromise *promise in upstreamPromises) {
+        [promise removeConsumer];
+    }
+    
+    // Run continuations right here, on the settling thread, rather than hopping to another queue.
+    for (LFPromiseSettleBlock callback in callbacks) {
+        callback(self);
+    }
+}
+
+- (void)whenSettled:(LFPromiseSettleBlock)block {
+    
+    pthread_mutex_lock(&_lock);
+    if (!self.settled) {
+        if (!self.callbacks) {
+            self.callbacks = [NSMutableArray array];
+        }
+        [self.callbacks addObject:[block copy]];
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    block(self);
+}
+
+- (void)resolveWithResult:(id)result {
+    
+    if ([result isKindOfClass:[NSError class]]) {
+        [self reject:result];
+        
+    } else if ([result isKindOfClass:[LFPromise class]]) {
+        LFPromise *promise = result;
+        [self waitOnPromise:promise];
+        [promise whenSettled:^(LFPromise *settledPromise) {
+            [self settleWithValue:settledPromise.value error:settledPromise.error];
+        }];
+        
+    } else {
+        [self settleWithValue:result error:nil];
+    }
+}
+
+- (void)addCancellable:(id)cancellable {
+    
+    pthread_mutex_lock(&_lock);
+    if (!self.settled) {
+        if (!self.cancellables) {
+            self.cancellables = [NSMutableArray array];
+        }
+        [self.cancellables addObject:cancellable];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)addCancellableOperation:(NSOperation *)operation {
+    [self addCancellable:operation];
+}
+
+- (void)waitOnPromise:(LFPromise *)promise {
+    
+    [promise addConsumer];
+    
+    pthread_mutex_lock(&_lock);
+    if (!self.settled) {
+        if (!self.upstreamPromises) {
+            self.upstreamPromises = [NSMutableArray array];
+        }
+        [self.upstreamPromises addObject:promise];
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    [promise removeConsumer];
+}
+
+- (void)addConsumer {
+    pthread_mutex_lock(&_lock);
+    self.consumerCount++;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)removeConsumer {
+    
+    BOOL abandoned = NO;
+    
+    pthread_mutex_lock(&_lock);
+    if (self.consumerCount > 0) {
+        self.consumerCount--;
+        abandoned = !self.settled && 0 == self.consumerCount;
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    if (abandoned) {
+        [self cancel];
+    }
+}
+
+- (void)cancel {
+    
+    NSArray *cancellables = nil;
+    
+    pthread_mutex_lock(&_lock);
+    if (self.settled) {
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    cancellables = [self.cancellables copy];
+    pthread_mutex_unlock(&_lock);
+    
+    [self reject:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    
+    for (id cancellable in cancellables) {
+        [cancellable cancel];
+    }
+}
+
+#pragma mark -
+#pragma mark Composition
+
+- (LFPromise *)then:(LFPromiseThenBlock)block {
+    
+    NSParameterAssert(block);
+    
+    LFPromise *promise = [self derivedPromise];
+    
+    [self whenSettled:^(LFPromise *settledPromise) {
+        if (settledPromise.error) {
+            [promise reject:settledPromise.error];
+        } else if (!promise.settled) {
+            [promise resolveWithResult:block(settledPromise.value)];
+        }
+    }];
+    
+    return promise;
+}
+
+- (LFPromise *)map:(LFPromiseMapBlock)block {
+    
+    NSParameterAssert(block);
+    
+    LFPromise *promise = [self derivedPromise];
+    
+    [self whenSettled:^(LFPromise *settledPromise) {
+        if (settledPromise.error) {
+            [promise reject:settledPromise.error];
+        } else if (!promise.settled) {
+            [promise settleWithValue:block(settledPromise.value) error:nil];
+        }
+    }];
+    
+    return promise;
+}
+
+- (LFPromise *)recover:(LFPromiseRecoverBlock)block {
+    
+    NSParameterAssert(block);
+    
+    LFPromise *promise = [self derivedPromise];
+    
+    [self whenSettled:^(LFPromise *settledPromise) {
+        if (!settledPromise.error) {
+            [promise settleWithValue:settledPromise.value error:nil];
+        } else if (!promise.settled) {
+            [promise resolveWithResult:block(settledPromise.error)];
+        }
+    }];
+    
+    return promise;
+}
+
+- (void)done:(LFPromiseDoneBlock)block {
+    
+    NSParameterAssert(block);
+    
+    dispatch_queue_t completionQueue = self.completionQueue ?: dispatch_get_main_queue();
+    
+    // A `done:` block cannot be cancelled, so it keeps this promise wanted for good.
+    [self addConsumer];
+    
+    [self whenSettled:^(LFPromise *settledPromise) {
+        dispatch_async(completionQueue, ^{
+            block(settledPromise.value, settledPromise.error);
+        });
+    }];
+}
+
++ (LFPromise *)all:(NSArray *)promises {
+    
+    LFPromise *promise = [[LFPromise alloc] init];
+    promise.completionQueue = [[promises firstObject] completionQueue];
+    
+    if (![promises count]) {
+        [promise fulfill:@[]];
+        return promise;
+    }
+    
+    NSMutableArray *values = [NSMutableArray arrayWithCapacity:[promises count]];
+    for (LFPromise *childPromise in promises) {
+        [values addObject:[NSNull null]];
+        [promise waitOnPromise:childPromise];
+    }
+    
+    __block NSUInteger remaining = [promises count];
+    
+    [promises enumerateObjectsUsingBlock:^(LFPromise *childPromise, NSUInteger idx, BOOL *stop) {
+        [childPromise whenSettled:^(LFPromise *settledPromise) {
+            
+            if (settledPromise.error) {
+                [promise reject:settledPromise.error];
+                return;
+            }
+            
+            BOOL finished = NO;
+            @synchronized(values) {
+                if (settledPromise.value) {
+                    values[idx] = settledPromise.value;
+                }
+                finished = (0 == --remaining);
+            }
+            
+            if (finished) {
+                [promise fulfill:[values copy]];
+            }
+        }];
+    }];
+    
+    return promise;
+}
+
++ (LFPromise *)any:(NSArray *)promises {
+    
+    LFPromise *promise = [[LFPromise alloc] init];
+    promise.completionQueue = [[promises firstObject] completionQueue];
+    
+    if (![promises count]) {
+        [promise reject:[NSError errorWithDomain:LFPromiseErrorDomain code:LFPromiseErrorNoPromises userInfo:nil]];
+        return promise;
+    }
+    
+    for (LFPromise *childPromise in promises) {
+        [promise waitOnPromise:childPromise];
+    }
+    
+    __block NSUInteger remaining = [promises count];
+    NSObject *lock = [[NSObject alloc] init];
+    
+    for (LFPromise *childPromise in promises) {
+        [childPromise whenSettled:^(LFPromise *settledPromise) {
+            
+            if (!settledPromise.error) {
+                [promise settleWithValue:settledPromise.value error:nil];
+                return;
+            }
+            
+            BOOL finished = NO;
+            @synchronized(lock) {
+                finished = (0 == --remaining);
+            }
+            
+            if (finished) {
+                [promise reject:settledPromise.error];
+            }
+        }];
+    }
+    
+    return promise;
+}
+
++ (LFPromise *)race:(NSArray *)promises {
+    
+    LFPromise *promise = [[LFPromise alloc] init];
+    promise.completionQueue = [[promises firstObject] completionQueue];
+    
+    if (![promises count]) {
+        [promise reject:[NSError errorWithDomain:LFPromiseErrorDomain code:LFPromiseErrorNoPromises userInfo:nil]];
+        return promise;
+    }
+    
+    for (LFPromise *childPromise in promises) {
+        [promise waitOnPromise:childPromise];
+    }
+    
+    for (LFPromise *childPromise in promises) {
+        [childPromise whenSettled:^(LFPromise *settledPromise) {
+            [promise settleWithValue:settledPromise.value error:settledPromise.error];
+        }];
+    }
+    
+    return promise;
+}
+
+@end
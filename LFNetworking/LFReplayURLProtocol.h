@@ -0,0 +1,76 @@
+//
+//  LFReplayURLProtocol.h
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+@class LFNetworkArchive;
+
+/** An `NSURLProtocol` that serves HTTP(S) requests from an `<LFNetworkArchive>` instead of the network.
+ *
+ * Together with `<LFNetworkArchiveWriter>` this allows recording real traffic once, then profiling and benchmarking
+ * the library's own overhead offline and reproducibly:
+ *
+ *     [LFReplayURLProtocol setArchive:archive];
+ *     NSURLSessionConfiguration *configuration = [LFReplayURLProtocol sessionConfigurationWithConfiguration:nil];
+ *     LFHTTPSessionManager *manager = [[LFHTTPSessionManager alloc] initWithBaseURL:baseURL sessionConfiguration:configuration];
+ *
+ * By default responses are delivered in one go as soon as loading starts. `latency` and `bytesPerSecond` simulate a
+ * slower network. Requests that are not in the archive fail with `NSURLErrorResourceUnavailable`, so nothing leaks
+ * out to the real network while an archive is set.
+ */
+
+@interface LFReplayURLProtocol : NSURLProtocol
+
+/// -------------------
+/// @name Configuration
+/// -------------------
+
+/** Set the archive responses are served from. While it is `nil` (default), the protocol handles no requests. */
++ (void)setArchive:(LFNetworkArchive *)archive;
+
+/** The archive responses are served from. */
++ (LFNetworkArchive *)archive;
+
+/** Set the delay before the response headers are delivered. Defaults to 0. */
++ (void)setLatency:(NSTimeInterval)latency;
+
+/** The delay before the response headers are delivered. */
++ (NSTimeInterval)latency;
+
+/** Set the rate at which the body is delivered, in bytes per second. Defaults to 0, which delivers it at once. */
++ (void)setBytesPerSecond:(NSUInteger)bytesPerSecond;
+
+/** The rate at which the body is delivered. */
++ (NSUInteger)bytesPerSecond;
+
+/** Return a copy of `configuration` with this protocol registered ahead of the system ones.
+ *
+ * @param configuration The configuration to copy. If `nil`, `+[NSURLSessionConfiguration defaultSessionConfiguration]` is used.
+ *
+ * @return The configuration to create the replaying session with.
+ */
++ (NSURLSessionConfiguration *)sessionConfigurationWithConfiguration:(NSURLSessionConfiguration *)configuration;
+
+@end
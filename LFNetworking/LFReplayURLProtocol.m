@@ -0,0 +1,188 @@
+//
+//  LFReplayURLProtocol.m
+//  LFNetworking
+//
+//  Created by the LFNetworking contributors on 10/18/26.
+//  Copyright (c) 2026 LFNetworking contributors. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "LFReplayURLProtocol.h"
+#import "LFNetworkArchive.h"
+
+/** How often a shaped body is delivered, in seconds. */
+static NSTimeInterval const LFReplayURLProtocolChunkInterval = 0.01;
+
+static LFNetworkArchive *_archive = nil;
+static NSTimeInterval _latency = 0;
+static NSUInteger _bytesPerSecond = 0;
+
+@interface LFReplayURLProtocol ()
+
+@property (nonatomic, strong) NSHTTPURLResponse *response;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, assign) NSUInteger bytesDelivered;
+@property (nonatomic, assign) NSUInteger chunkLength;
+@property (nonatomic, strong) NSTimer *timer;
+
+- (void)deliverResponse;
+- (void)deliverChunk:(NSTimer *)timer;
+
+@end
+
+@implementation LFReplayURLProtocol
+
+#pragma mark -
+#pragma mark Configuration
+
++ (void)setArchive:(LFNetworkArchive *)archive {
+    @synchronized(self) {
+        _archive = archive;
+    }
+}
+
++ (LFNetworkArchive *)archive {
+    @synchronized(self) {
+        return _archive;
+    }
+}
+
++ (void)setLatency:(NSTimeInterval)latency {
+    @synchronized(self) {
+        _latency = latency;
+    }
+}
+
++ (NSTimeInterval)latency {
+    @synchronized(self) {
+        return _latency;
+    }
+}
+
++ (void)setBytesPerSecond:(NSUInteger)bytesPerSecond {
+    @synchronized(self) {
+        _bytesPerSecond = bytesPerSecond;
+    }
+}
+
++ (NSUInteger)bytesPerSecond {
+    @synchronized(self) {
+        return _bytesPerSecond;
+    }
+}
+
++ (NSURLSessionConfiguration *)sessionConfigurationWithConfiguration:(NSURLSessionConfiguration *)configuration {
+    
+    NSURLSessionConfiguration *replayConfiguration = [configuration copy] ?: [NSURLSessionConfiguration defaultSessionConfiguration];
+    
+    NSMutableArray *protocolClasses = [NSMutableArray arrayWithObject:self];
+    if (replayConfiguration.protocolClasses) {
+        [protocolClasses addObjectsFromArray:replayConfiguration.protocolClasses];
+    }
+    replayConfiguration.protocolClasses = protocolClasses;
+    
+    return replayConfiguration;
+}
+
+#pragma mark -
+#pragma mark NSURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    NSString *scheme = [[request.URL scheme] lowercaseString];
+    return [self archive] && ([scheme isEqualToString:@"http"] || [scheme isEqualToString:@"https"]);
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    
+    NSData *data = nil;
+    NSHTTPURLResponse *response = [[[self class] archive] responseForRequest:self.request data:&data];
+    
+    if (!response) {
+        NSDictionary *userInfo = @{NSURLErrorFailingURLErrorKey: self.request.URL,
+                                   NSLocalizedDescriptionKey: [NSString stringWithFormat:@"No archived response for %@", [LFNetworkArchive keyForRequest:self.request]]};
+        [self.client URLProtocol:self didFailWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorResourceUnavailable userInfo:userInfo]];
+        return;
+    }
+    
+    self.response = response;
+    self.data = data;
+    
+    NSTimeInterval latency = [[self class] latency];
+    NSUInteger bytesPerSecond = [[self class] bytesPerSecond];
+    self.chunkLength = bytesPerSecond ? MAX((NSUInteger)(bytesPerSecond * LFReplayURLProtocolChunkInterval), (NSUInteger)1) : [data length];
+    
+    if (latency <= 0 && !bytesPerSecond) {
+        [self deliverResponse];
+        [self deliverChunk:nil];
+        return;
+    }
+    
+    // Client callbacks have to come from the thread that started loading, so schedule on its run loop.
+    self.timer = [NSTimer timerWithTimeInterval:MAX(latency, 0) target:self selector:@selector(deliverResponse) userInfo:nil repeats:NO];
+    [[NSRunLoop currentRunLoop] addTimer:self.timer forMode:NSRunLoopCommonModes];
+}
+
+- (void)stopLoading {
+    [self.timer invalidate];
+    self.timer = nil;
+}
+
+#pragma mark -
+#pragma mark Delivery
+
+- (void)deliverResponse {
+    
+    [self.client URLProtocol:self didReceiveResponse:self.response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    
+    if (self.timer) {
+        self.timer = [NSTimer timerWithTimeInterval:LFReplayURLProtocolChunkInterval target:self selector:@selector(deliverChunk:) userInfo:nil repeats:YES];
+        [[NSRunLoop currentRunLoop] addTimer:self.timer forMode:NSRunLoopCommonModes];
+        [self deliverChunk:self.timer];
+    }
+}
+
+- (void)deliverChunk:(NSTimer *)timer {
+    
+    NSUInteger remaining = [self.data length] - self.bytesDelivered;
+    NSUInteger length = MIN(remaining, self.chunkLength);
+    
+    if (length) {
+        // -subdataWithRange: would copy, so slice the archive-backed body instead, keeping it alive until the chunk goes away.
+        NSData *data = self.data;
+        NSData *chunk = (length == [data length]) ? data : [[NSData alloc] initWithBytesNoCopy:(void *)((const uint8_t *)[data bytes] + self.bytesDelivered)
+                                                                                        length:length
+                                                                                   deallocator:^(void *bytes, NSUInteger length) {
+                                                                                       (void)data;
+                                                                                   }];
+        self.bytesDelivered += length;
+        [self.client URLProtocol:self didLoadData:chunk];
+    }
+    
+    if (self.bytesDelivered == [self.data length]) {
+        [timer invalidate];
+        self.timer = nil;
+        [self.client URLProtocolDidFinishLoading:self];
+    }
+}
+
+@end
@@ -26,6 +26,9 @@
 #import <Foundation/Foundation.h>
 #import "LFNetworkDataTaskOperation.h"
 #import "AFSecurityPolicy.h"
+#import "LFNetworkTracer.h"
+#import "LFPromise.h"
+#import "LFNetworkArchive.h"
 
 @class LFURLSessionManager;
 
@@ -38,6 +41,9 @@ typedef void(^LFURLSessionDidReceiveChallengeBlock)(LFURLSessionManager *manager
 typedef void(^LFURLSessionManagerURLSessionTaskDidCompleteBlock)(LFURLSessionManager *manager,
                                                               NSURLSessionTask *task,
                                                               NSError *error);
+typedef void(^LFURLSessionTaskDidCompleteBlock)(NSURLResponse *response,
+                                                NSData *data,
+                                                NSError *error);
 @interface LFURLSessionManager : NSObject
 
 /// ----------------
@@ -121,6 +127,28 @@ NSURLAuthenticationChallenge *challenge,
  */
 @property (nonatomic, strong) dispatch_queue_t completionQueue;
 
+///--------------
+/// @name Tracing
+///--------------
+
+/** The tracer that operations created by this manager record their lifecycle into. Defaults to `nil`, which disables tracing.
+ *
+ * Each operation gets its own trace identifier, so that `-[LFNetworkTracer traceEventData]` shows one track
+ * per request, with `queued` (including time spent waiting on dependencies), `task`, `serialization` and
+ * `delivery` spans.
+ */
+@property (nonatomic, strong) LFNetworkTracer *tracer;
+
+///----------------
+/// @name Recording
+///----------------
+
+/** When set, every data task of the managed session that completes successfully is recorded into this archive writer, regardless of which operation (if any) handles it. Defaults to `nil`.
+ *
+ * Replay the archive with `LFReplayURLProtocol` to exercise the library without a network.
+ */
+@property (nonatomic, strong) LFNetworkArchiveWriter *archiveWriter;
+
 ///---------------------
 /// @name Initialization
 ///---------------------
@@ -154,6 +182,23 @@ NSURLAuthenticationChallenge *challenge,
                                          progressHandler:(LFURLSessionDataTaskProgressBlock)progressHandler
                                        completionHandler:(LFURLSessionTaskDidCompleteWithDataErrorBlock)didCompleteWithDataErrorHandler;
 
+/** Create data task operation with a deadline.
+ *
+ * @param request The `NSURLRequest`
+ * @param deadline The time after which the response is no longer useful. See `-[LFNetworkTaskOperation deadline]`.
+ * @param progressHandler The block that will be called with as the data is being downloaded.
+ * @param didCompleteWithDataErrorHandler The block that will be called when task is done.
+ *
+ * @return Returns `LFNetworkDataTaskOperation`.
+ *
+ * @note The request's `timeoutInterval` is lowered to the time remaining until `deadline`, if that is shorter.
+ */
+
+- (LFNetworkDataTaskOperation *)dataOperationWithRequest:(NSURLRequest *)request
+                                                deadline:(NSDate *)deadline
+                                         progressHandler:(LFURLSessionDataTaskProgressBlock)progressHandler
+                                       completionHandler:(LFURLSessionTaskDidCompleteWithDataErrorBlock)didCompleteWithDataErrorHandler;
+
 /** Create data task operation.
  *
  * @param url The `NSURL`.
@@ -174,6 +219,55 @@ NSURLAuthenticationChallenge *challenge,
                                      progressHandler:(LFURLSessionDataTaskProgressBlock)progressHandler
                                    completionHandler:(LFURLSessionTaskDidCompleteWithDataErrorBlock)didCompleteWithDataErrorHandler;
 
+/// ---------------
+/// @name Promises
+/// ---------------
+
+/** Create and enqueue a data task operation, returning a promise for its data.
+ *
+ * @param request The `NSURLRequest`
+ *
+ * @return Returns an `LFPromise` fulfilled with the response `NSData`, or rejected with the task's error.
+ *
+ * @note The promise is settled directly on the session's delegate queue, so a `then:` continuation that starts the next
+ *       request does so without going through `completionQueue`. Only `done:` blocks are dispatched there.
+ *       Cancelling the promise cancels the operation.
+ */
+
+- (LFPromise *)promiseWithRequest:(NSURLRequest *)request;
+
+/// -------------------
+/// @name Direct Tasks
+/// -------------------
+
+/** The number of tasks started with `directDataTaskWithRequest:completionHandler:` that may run at once. Defaults to 8, and must be at least 1.
+ *
+ * Tasks beyond the limit wait, in the order they were created, for a running one to complete. Raising the limit starts
+ * waiting tasks right away. Operations added with `addOperation:` do not count against it.
+ */
+@property (nonatomic, assign) NSUInteger maxConcurrentDirectTaskCount;
+
+/** Create and start a data task without an operation.
+ *
+ * This is the fast path for large numbers of small, independent requests: the task is tracked by a small, recycled
+ * internal record instead of an `<LFNetworkDataTaskOperation>`, so it skips the operation queue, its KVO
+ * notifications and the per-callback handler blocks. Use `dataOperationWithRequest:progressHandler:completionHandler:`
+ * for requests that need dependencies, deadlines, progress or per-task challenge handling.
+ *
+ * @param request The `NSURLRequest`
+ * @param completionHandler The block that will be called on `<completionQueue>` when the task is done.
+ *
+ * @return Returns the `NSURLSessionDataTask`, which is resumed as soon as a direct task slot is free. Cancel it to abandon the request.
+ *
+ * @note Unlike the operation path, responses with an HTTP error status are delivered as is; inspect `response` rather than `error`.
+ *
+ * @warning Do not call `-resume` on the returned task: the manager does so when a slot is free. A task resumed early
+ *          runs outside the limit and is still delivered, but keeps its place in the queue until it completes.
+ */
+
+- (NSURLSessionDataTask *)directDataTaskWithRequest:(NSURLRequest *)request
+                                  completionHandler:(LFURLSessionTaskDidCompleteBlock)completionHandler;
+
 /// -----------------------------------------------
 /// @name NSOperationQueue utility methods
 /// -----------------------------------------------
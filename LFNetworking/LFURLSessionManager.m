@@ -24,8 +24,20 @@
 // THE SOFTWARE.
 
 #import "LFURLSessionManager.h"
+#import "LFNetworkTaskRecord.h"
 
-@interface LFURLSessionManager () <NSURLSessionDelegate, NSURLSessionTaskDelegate, NSURLSessionDataDelegate>
+#import <pthread.h>
+#import <stdatomic.h>
+
+static NSUInteger const LFURLSessionManagerDefaultMaxConcurrentDirectTaskCount = 8;
+static NSUInteger const LFURLSessionManagerDirectRecordPoolLimit = 64;
+
+@interface LFURLSessionManager () <NSURLSessionDelegate, NSURLSessionTaskDelegate, NSURLSessionDataDelegate> {
+    pthread_mutex_t _directLock;
+    NSUInteger _runningDirectTaskCount;
+    // Checked without the lock, so that callbacks for operation tasks skip the lookup while no direct task is around.
+    atomic_uint_fast64_t _outstandingDirectTaskCount;
+}
 
 @property (readwrite, nonatomic, strong) NSURLSessionConfiguration *sessionConfiguration;
 @property (readwrite, nonatomic, strong) NSURLSession *session;
@@ -36,6 +48,19 @@
 - (void)removeTaskOperationForTask:(NSURLSessionTask *)task;
 - (void)addTaskToOperationsWithTaskOperation:(LFNetworkTaskOperation *)taskOperation;
 
+/** Direct task records by task, compared by pointer. Guarded by `_directLock`. */
+@property (nonatomic, strong) NSMapTable *directRecords;
+
+/** Records waiting for a direct task slot, oldest first. Guarded by `_directLock`. */
+@property (nonatomic, strong) NSMutableArray *pendingDirectRecords;
+
+/** Records ready for reuse. Guarded by `_directLock`. */
+@property (nonatomic, strong) NSMutableArray *directRecordPool;
+
+- (LFNetworkTaskRecord *)directRecordForTask:(NSURLSessionTask *)task;
+- (NSURLSessionTask *)dequeuePendingDirectTaskLocked;
+- (BOOL)completeDirectTask:(NSURLSessionTask *)task error:(NSError *)error;
+
 @end
 
 @implementation LFURLSessionManager
@@ -66,9 +91,21 @@
     
     self.operations = [[NSMutableDictionary alloc] init];
     
+    pthread_mutex_init(&_directLock, NULL);
+    atomic_init(&_outstandingDirectTaskCount, 0);
+    _maxConcurrentDirectTaskCount = LFURLSessionManagerDefaultMaxConcurrentDirectTaskCount;
+    self.directRecords = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory];
+    self.pendingDirectRecords = [[NSMutableArray alloc] init];
+    self.directRecordPool = [[NSMutableArray alloc] init];
+    
     return self;
 }
 
+- (void)dealloc {
+    pthread_mutex_destroy(&_directLock);
+}
+
 - (LFNetworkDataTaskOperation *)dataOperationWithRequest:(NSURLRequest *)request
                                          progressHandler:(LFURLSessionDataTaskProgressBlock)progressHandler
                                        completionHandler:(LFURLSessionTaskDidCompleteWithDataErrorBlock)didCompleteWithDataErrorHandler {
@@ -82,11 +119,40 @@
     operation.didCompleteWithDataErrorHandler = didCompleteWithDataErrorHandler;
     operation.completionQueue = self.completionQueue;
     
+    LFNetworkTracer *tracer = self.tracer;
+    if (tracer) {
+        operation.tracer = tracer;
+        operation.traceIdentifier = [tracer nextIdentifier];
+    }
+    
     [self addTaskToOperationsWithTaskOperation:operation];
     
     return operation;
 }
 
+- (LFNetworkDataTaskOperation *)dataOperationWithRequest:(NSURLRequest *)request
+                                                deadline:(NSDate *)deadline
+                                         progressHandler:(LFURLSessionDataTaskProgressBlock)progressHandler
+                                       completionHandler:(LFURLSessionTaskDidCompleteWithDataErrorBlock)didCompleteWithDataErrorHandler {
+    
+    NSParameterAssert(request);
+    
+    // The task is created along with the operation, so this is the only chance to spend the remaining budget as its timeout.
+    NSTimeInterval remaining = [deadline timeIntervalSinceNow];
+    if (deadline && remaining > 0 && remaining < request.timeoutInterval) {
+        NSMutableURLRequest *mutableRequest = [request mutableCopy];
+        mutableRequest.timeoutInterval = remaining;
+        request = mutableRequest;
+    }
+    
+    LFNetworkDataTaskOperation *operation = [self dataOperationWithRequest:request
+                                                           progressHandler:progressHandler
+                                                         completionHandler:didCompleteWithDataErrorHandler];
+    operation.deadline = deadline;
+    
+    return operation;
+}
+
 - (LFNetworkDataTaskOperation *)dataOperationWithURL:(NSURL *)url
                                      progressHandler:(LFURLSessionDataTaskProgressBlock)progressHandler
                                    completionHandler:(LFURLSessionTaskDidCompleteWithDataErrorBlock)didCompleteWithDataErrorHandler {
@@ -98,6 +164,185 @@
                         completionHandler:didCompleteWithDataErrorHandler];
 }
 
+#pragma mark -
+#pragma mark Promises
+
+- (LFPromise *)promiseWithRequest:(NSURLRequest *)request {
+    
+    NSParameterAssert(request);
+    
+    LFPromise *promise = [[LFPromise alloc] init];
+    promise.completionQueue = self.completionQueue;
+    
+    LFNetworkDataTaskOperation *operation = [self dataOperationWithRequest:request progressHandler:nil completionHandler:^(LFNetworkTaskOperation *operation, NSData *data, NSError *error) {
+        if (error) {
+            [promise reject:error];
+        } else {
+            [promise fulfill:data];
+        }
+    }];
+    operation.completesOnDelegateQueue = YES;
+    
+    [promise addCancellableOperation:operation];
+    [self addOperation:operation];
+    
+    return promise;
+}
+
+#pragma mark -
+#pragma mark Direct Tasks
+
+- (void)setMaxConcurrentDirectTaskCount:(NSUInteger)maxConcurrentDirectTaskCount {
+    
+    // With no slot at all, direct tasks would wait forever.
+    NSParameterAssert(maxConcurrentDirectTaskCount > 0);
+    maxConcurrentDirectTaskCount = MAX(maxConcurrentDirectTaskCount, (NSUInteger)1);
+    
+    NSMutableArray *tasks = [NSMutableArray array];
+    
+    pthread_mutex_lock(&_directLock);
+    _maxConcurrentDirectTaskCount = maxConcurrentDirectTaskCount;
+    NSURLSessionTask *task;
+    while ((task = [self dequeuePendingDirectTaskLocked])) {
+        [tasks addObject:task];
+    }
+    pthread_mutex_unlock(&_directLock);
+    
+    [tasks makeObjectsPerformSelector:@selector(resume)];
+}
+
+- (NSURLSessionDataTask *)directDataTaskWithRequest:(NSURLRequest *)request
+                                  completionHandler:(LFURLSessionTaskDidCompleteBlock)completionHandler {
+    
+    NSParameterAssert(request);
+    
+    NSURLSessionDataTask *task = [self.session dataTaskWithRequest:request];
+    
+    LFNetworkTracer *tracer = self.tracer;
+    uint64_t traceIdentifier = [tracer nextIdentifier];
+    [tracer recordEvent:LFNetworkTraceEnqueued identifier:traceIdentifier value:0];
+    [tracer beginSpan:LFNetworkTraceQueued identifier:traceIdentifier];
+    
+    pthread_mutex_lock(&_directLock);
+    
+    LFNetworkTaskRecord *record = [self.directRecordPool lastObject];
+    if (record) {
+        [self.directRecordPool removeLastObject];
+    } else {
+        record = [[LFNetworkTaskRecord alloc] init];
+    }
+    
+    record.task = task;
+    record.completionHandler = completionHandler;
+    record.tracer = tracer;
+    record.traceIdentifier = traceIdentifier;
+    record.pending = YES;
+    
+    [self.directRecords setObject:record forKey:task];
+    [self.pendingDirectRecords addObject:record];
+    atomic_fetch_add(&_outstandingDirectTaskCount, 1);
+    
+    NSURLSessionTask *startTask = [self dequeuePendingDirectTaskLocked];
+    
+    pthread_mutex_unlock(&_directLock);
+    
+    [startTask resume];
+    
+    return task;
+}
+
+- (LFNetworkTaskRecord *)directRecordForTask:(NSURLSessionTask *)task {
+    
+    // The count goes up before a direct task is resumed, so a zero here means this task is not one of them.
+    if (0 == atomic_load(&_outstandingDirectTaskCount)) {
+        return nil;
+    }
+    
+    pthread_mutex_lock(&_directLock);
+    LFNetworkTaskRecord *record = [self.directRecords objectForKey:task];
+    pthread_mutex_unlock(&_directLock);
+    
+    return record;
+}
+
+// Must be called with _directLock held. The caller resumes the returned task once it has released the lock.
+- (NSURLSessionTask *)dequeuePendingDirectTaskLocked {
+    
+    if (_runningDirectTaskCount >= _maxConcurrentDirectTaskCount || 0 == [self.pendingDirectRecords count]) {
+        return nil;
+    }
+    
+    LFNetworkTaskRecord *record = self.pendingDirectRecords[0];
+    [self.pendingDirectRecords removeObjectAtIndex:0];
+    record.pending = NO;
+    _runningDirectTaskCount++;
+    
+    [record.tracer endSpan:LFNetworkTraceQueued identifier:record.traceIdentifier];
+    [record.tracer recordEvent:LFNetworkTraceStarted identifier:record.traceIdentifier value:0];
+    [record.tracer beginSpan:LFNetworkTraceTask identifier:record.traceIdentifier];
+    
+    return record.task;
+}
+
+- (BOOL)completeDirectTask:(NSURLSessionTask *)task error:(NSError *)error {
+    
+    if (0 == atomic_load(&_outstandingDirectTaskCount)) {
+        return NO;
+    }
+    
+    pthread_mutex_lock(&_directLock);
+    
+    LFNetworkTaskRecord *record = [self.directRecords objectForKey:task];
+    if (!record) {
+        pthread_mutex_unlock(&_directLock);
+        return NO;
+    }
+    
+    [self.directRecords removeObjectForKey:task];
+    atomic_fetch_sub(&_outstandingDirectTaskCount, 1);
+    
+    NSURLSessionTask *nextTask = nil;
+    if ([record isPending]) {
+        [self.pendingDirectRecords removeObjectIdenticalTo:record];
+        [record.tracer endSpan:LFNetworkTraceQueued identifier:record.traceIdentifier];
+        // A task that was never started can only end by being cancelled. Anything else means the caller resumed it outside the limiter.
+        BOOL cancelled = [error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled && !record.response;
+        if (cancelled) {
+            [record.tracer recordEvent:LFNetworkTraceCancelled identifier:record.traceIdentifier value:0];
+        }
+    } else {
+        _runningDirectTaskCount--;
+        [record.tracer endSpan:LFNetworkTraceTask identifier:record.traceIdentifier];
+        nextTask = [self dequeuePendingDirectTaskLocked];
+    }
+    
+    LFURLSessionTaskDidCompleteBlock completionHandler = record.completionHandler;
+    NSURLResponse *response = record.response;
+    NSData *data = record.data;
+    LFNetworkTracer *tracer = record.tracer;
+    uint64_t traceIdentifier = record.traceIdentifier;
+    
+    [record prepareForReuse];
+    if ([self.directRecordPool count] < LFURLSessionManagerDirectRecordPoolLimit) {
+        [self.directRecordPool addObject:record];
+    }
+    
+    pthread_mutex_unlock(&_directLock);
+    
+    [nextTask resume];
+    
+    if (completionHandler) {
+        [tracer beginSpan:LFNetworkTraceDelivery identifier:traceIdentifier];
+        dispatch_async(self.completionQueue ?: dispatch_get_main_queue(), ^{
+            [tracer endSpan:LFNetworkTraceDelivery identifier:traceIdentifier];
+            completionHandler(response, data, error);
+            [tracer recordEvent:LFNetworkTraceDelivered identifier:traceIdentifier value:0];
+        });
+    }
+    
+    return YES;
+}
+
 #pragma mark -
 #pragma mark NSOperationQueue
 
@@ -114,6 +359,13 @@
 }
 
 - (void)addOperation:(NSOperation *)operation {
+    
+    if ([operation isKindOfClass:[LFNetworkTaskOperation class]]) {
+        LFNetworkTaskOperation *taskOperation = (LFNetworkTaskOperation *)operation;
+        [taskOperation.tracer recordEvent:LFNetworkTraceEnqueued identifier:taskOperation.traceIdentifier value:(int64_t)[operation.dependencies count]];
+        [taskOperation.tracer beginSpan:LFNetworkTraceQueued identifier:taskOperation.traceIdentifier];
+    }
+    
     [[[self class] sharedNetworkOperationQueue] addOperation:operation];
 }
 
@@ -209,11 +461,30 @@
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
     
+    [self.archiveWriter task:task didCompleteWithError:error];
+    
+    if ([self completeDirectTask:task error:error]) {
+        return;
+    }
+    
     LFNetworkTaskOperation *operation = [self taskOperationWithURLSessionTask:task];
     
+    // The task was cancelled because its result would have arrived too late, report that rather than a plain cancellation.
+    if ([operation isDeadlineExceeded] && [error.domain isEqualToString:NSURLErrorDomain] && NSURLErrorCancelled == error.code) {
+        NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithObject:@"The operation's deadline passed before it could finish." forKey:NSLocalizedDescriptionKey];
+        if (error) {
+            userInfo[NSUnderlyingErrorKey] = error;
+        }
+        error = [NSError errorWithDomain:LFNetworkTaskOperationErrorDomain code:LFNetworkTaskOperationErrorDeadlineExceeded userInfo:userInfo];
+    }
+    
     if ([operation respondsToSelector:@selector(URLSession:task:didCompleteWithError:)] && operation.didCompleteWithDataErrorHandler) {
         [operation URLSession:session task:task didCompleteWithError:error];
     } else {
+        if ([operation isExecuting]) {
+            [operation.tracer endSpan:LFNetworkTraceTask identifier:operation.traceIdentifier];
+        }
+        
         if (self.didCompleteHandler) {
             dispatch_async(self.completionQueue ?: dispatch_get_main_queue(), ^{
                 self.didCompleteHandler(self, task, error);
@@ -299,6 +570,18 @@
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler
 {
+    // Records are only recycled on this (serial) delegate queue, so the one found here stays ours for the rest of the callback.
+    LFNetworkTaskRecord *record = [self directRecordForTask:dataTask];
+    if (record) {
+        record.response = response;
+        if (record.tracer) {
+            NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? [(NSHTTPURLResponse *)response statusCode] : 0;
+            [record.tracer recordEvent:LFNetworkTraceResponse identifier:record.traceIdentifier value:statusCode];
+        }
+        completionHandler(NSURLSessionResponseAllow);
+        return;
+    }
+    
     LFNetworkDataTaskOperation *operation = (LFNetworkDataTaskOperation *)[self taskOperationWithURLSessionTask:dataTask];
     
     if ([operation respondsToSelector:@selector(URLSession:dataTask:didReceiveResponse:completionHandler:)]) {
@@ -310,6 +593,15 @@
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
 {
+    [self.archiveWriter task:dataTask didReceiveData:data];
+    
+    LFNetworkTaskRecord *record = [self directRecordForTask:dataTask];
+    if (record) {
+        [record.tracer recordEvent:LFNetworkTraceData identifier:record.traceIdentifier value:(int64_t)[data length]];
+        [record appendData:data];
+        return;
+    }
+    
     LFNetworkDataTaskOperation *operation = (LFNetworkDataTaskOperation *)[self taskOperationWithURLSessionTask:dataTask];
     
     if ([operation respondsToSelector:@selector(URLSession:dataTask:didReceiveData:)]) {